@@ -0,0 +1,53 @@
+#ifndef CLUB_BENCH_HPP_
+#define CLUB_BENCH_HPP_
+
+#include "club.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace bench
+{
+    using Clock = std::chrono::steady_clock;
+    using String = club::String;
+
+    struct Result
+    {
+        String name;
+        double value;
+        String unit;
+    };
+    using Results = std::vector<Result>;
+    using Benchmark = std::function<void(club::ContextPtr context, Results& results)>;
+
+    bool Register(const String& name, Benchmark benchmark);
+
+    double Seconds(const Clock::time_point& begin, const Clock::time_point& end);
+    // Failed enqueues return no event, they are logged by club and must not crash the run
+    void Wait(const club::EventPtr& event);
+    // Bandwidths are better when higher, times when lower
+    bool HigherIsBetter(const String& unit);
+
+    // One untimed run warms up caches and lazy driver state before the timed repetitions
+    template <typename F> double Median(std::size_t repetitions, F&& function)
+    {
+        std::vector<double> times(repetitions);
+
+        function();
+
+        for (auto& it : times)
+        {
+            auto begin = Clock::now();
+            function();
+            it = Seconds(begin, Clock::now());
+        }
+
+        std::sort(times.begin(), times.end());
+
+        return times[times.size() / 2];
+    }
+} // namespace bench
+
+#endif
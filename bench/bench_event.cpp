@@ -0,0 +1,102 @@
+#include "bench.hpp"
+
+#include <memory>
+
+namespace bench
+{
+    // The event handle as it was before events became lazy: heap allocated and queried eagerly with size and value calls
+    struct EagerEvent
+    {
+        explicit EagerEvent(cl_event value) : event(value)
+        {
+            Query(CL_EVENT_COMMAND_QUEUE, queue);
+            Query(CL_EVENT_CONTEXT, context);
+            Query(CL_EVENT_COMMAND_TYPE, type);
+            Query(CL_EVENT_COMMAND_EXECUTION_STATUS, status);
+        }
+        ~EagerEvent()
+        {
+            clReleaseEvent(event);
+        }
+
+        template <typename T> void Query(cl_event_info info, T& value) const
+        {
+            std::size_t size;
+
+            clGetEventInfo(event, info, 0, NULL, &size);
+            clGetEventInfo(event, info, size, &value, NULL);
+        }
+
+        cl_event event;
+        cl_command_queue queue{ nullptr };
+        cl_context context{ nullptr };
+        cl_command_type type{ 0 };
+        cl_int status{ 0 };
+    };
+
+    static void Event(club::ContextPtr context, Results& results)
+    {
+        const std::size_t repetitions = 5;
+        const std::size_t operations = 10000;
+        cl_uint value = 0;
+
+        auto buffer = club::CreateBuffer(context, sizeof(value));
+        auto eventless = context->AddQueue();
+        if (!buffer || !eventless)
+        {
+            return;
+        }
+
+        eventless->SetEvents(false);
+
+        auto queue = context->GetQueuePtr();
+        auto perOperation = [&](double seconds) { return seconds * 1e6 / operations; };
+
+        // What every enqueue paid before events became lazy, the write is issued directly to keep only the handle cost
+        auto eager = Median(repetitions, [&]()
+        {
+            for (std::size_t i = 0; i < operations; ++i)
+            {
+                cl_event event{ nullptr };
+                if (clEnqueueWriteBuffer(queue->Get(), buffer->Get(), CL_FALSE, 0, sizeof(value), &value, 0, NULL, &event) == CL_SUCCESS)
+                {
+                    std::make_shared<EagerEvent>(event);
+                }
+            }
+            queue->Finish();
+        });
+        auto pooled = Median(repetitions, [&]()
+        {
+            for (std::size_t i = 0; i < operations; ++i)
+            {
+                buffer->Write(queue, 0, sizeof(value), &value);
+            }
+            queue->Finish();
+        });
+        auto none = Median(repetitions, [&]()
+        {
+            for (std::size_t i = 0; i < operations; ++i)
+            {
+                buffer->Write(eventless, 0, sizeof(value), &value);
+            }
+            eventless->Finish();
+        });
+
+        // Wrapping alone, without the enqueue, isolates the cost of the handle
+        auto wrap = Median(repetitions, [&]()
+        {
+            for (std::size_t i = 0; i < operations; ++i)
+            {
+                cl_event event = clCreateUserEvent(context->Get(), NULL);
+                club::CreateEvent(event);
+            }
+        });
+
+        results.push_back({ "write_event_eager_info", perOperation(eager), "us" });
+        results.push_back({ "write_event_lazy_pooled", perOperation(pooled), "us" });
+        results.push_back({ "write_eventless", perOperation(none), "us" });
+        results.push_back({ "event_wrap", perOperation(wrap), "us" });
+    }
+
+    static bool registered = Register("event", Event);
+} // namespace bench
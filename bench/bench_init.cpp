@@ -0,0 +1,54 @@
+#include "bench.hpp"
+
+#include <filesystem>
+
+namespace bench
+{
+    static const club::String initSource = R"(
+        __kernel void saxpy(__global float* y, __global const float* x, const float a)
+        {
+            size_t id = get_global_id(0);
+            y[id] = mad(a, x[id], y[id]);
+        }
+    )";
+
+    static void Init(club::ContextPtr context, Results& results)
+    {
+        const std::size_t repetitions = 5;
+        std::size_t salt = 0;
+
+        club::PlatformFilter eager;
+        eager.print = false;
+
+        club::PlatformFilter lazy = eager;
+        lazy.lazy = true;
+
+        auto platformEager = Median(repetitions, [&]() { club::CreatePlatform(eager); });
+        auto platformLazy = Median(repetitions, [&]() { club::CreatePlatform(lazy); });
+
+        // A private cache directory keeps the results independent from earlier runs
+        auto previous = club::GetCacheDirectory();
+        auto directory = std::filesystem::temp_directory_path() / "club_bench_cache";
+        std::filesystem::remove_all(directory);
+        club::SetCacheDirectory(directory.string());
+
+        // Every cold build gets new options so neither the club cache nor the driver can reuse a binary
+        auto cold = Median(repetitions, [&]()
+        {
+            club::CreateProgramFromString(context, initSource, club::defaultBuildOptions + " -D CLUB_BENCH_SALT=" + std::to_string(salt++));
+        });
+
+        club::CreateProgramFromString(context, initSource);
+        auto warm = Median(repetitions, [&]() { club::CreateProgramFromString(context, initSource); });
+
+        club::SetCacheDirectory(previous);
+        std::filesystem::remove_all(directory);
+
+        results.push_back({ "platform_eager", platformEager * 1e3, "ms" });
+        results.push_back({ "platform_lazy", platformLazy * 1e3, "ms" });
+        results.push_back({ "program_cold", cold * 1e3, "ms" });
+        results.push_back({ "program_warm", warm * 1e3, "ms" });
+    }
+
+    static bool registered = Register("init", Init);
+} // namespace bench
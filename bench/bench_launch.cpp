@@ -0,0 +1,82 @@
+#include "bench.hpp"
+
+namespace bench
+{
+    static const club::String emptySource = R"(
+        __kernel void empty(__global int* data, const int value)
+        {
+        }
+    )";
+
+    static void Launch(club::ContextPtr context, Results& results)
+    {
+        const std::size_t repetitions = 5;
+        const std::size_t launches = 1000;
+        const std::size_t calls = 100000;
+        cl_int value = 0;
+
+        auto program = club::CreateProgramFromString(context, emptySource);
+        auto kernel = program ? club::CreateKernel(program, "empty", 1) : nullptr;
+        auto buffer = club::CreateBuffer(context, sizeof(cl_int));
+        if (!kernel || !buffer)
+        {
+            return;
+        }
+
+        kernel->SetArgs(buffer, value);
+        kernel->SetLocalSize(club::LocalSize{ 1 });
+
+        auto queue = context->GetQueuePtr();
+        auto perLaunch = [&](double seconds) { return seconds * 1e6 / launches; };
+        auto perCall = [&](double seconds) { return seconds * 1e9 / calls; };
+
+        // The first launch compiles and uploads the kernel on some drivers and is kept out of the timings
+        kernel->Enqueue({ 1 })->Wait();
+
+        auto blocking = Median(repetitions, [&]()
+        {
+            for (std::size_t i = 0; i < launches; ++i)
+            {
+                kernel->Enqueue({ 1 })->Wait();
+            }
+        });
+        auto pipelined = Median(repetitions, [&]()
+        {
+            for (std::size_t i = 0; i < launches; ++i)
+            {
+                kernel->Enqueue({ 1 });
+            }
+            queue->Finish();
+        });
+
+        auto raw = Median(repetitions, [&]()
+        {
+            for (std::size_t i = 0; i < calls; ++i)
+            {
+                kernel->SetArg(1, sizeof(value), &value);
+            }
+        });
+        auto unchanged = Median(repetitions, [&]()
+        {
+            for (std::size_t i = 0; i < calls; ++i)
+            {
+                kernel->SetArgs(buffer, value);
+            }
+        });
+        auto changed = Median(repetitions, [&]()
+        {
+            for (std::size_t i = 0; i < calls; ++i)
+            {
+                kernel->SetArg(1, static_cast<cl_int>(i));
+            }
+        });
+
+        results.push_back({ "empty_kernel_blocking", perLaunch(blocking), "us" });
+        results.push_back({ "empty_kernel_pipelined", perLaunch(pipelined), "us" });
+        results.push_back({ "set_arg_raw", perCall(raw), "ns" });
+        results.push_back({ "set_args_unchanged", perCall(unchanged), "ns" });
+        results.push_back({ "set_arg_changed", perCall(changed), "ns" });
+    }
+
+    static bool registered = Register("launch", Launch);
+} // namespace bench
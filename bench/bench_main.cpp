@@ -0,0 +1,275 @@
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace bench
+{
+    static std::map<String, Benchmark>& GetBenchmarks()
+    {
+        static std::map<String, Benchmark> benchmarks;
+
+        return benchmarks;
+    }
+    bool Register(const String& name, Benchmark benchmark)
+    {
+        GetBenchmarks()[name] = benchmark;
+
+        return true;
+    }
+    double Seconds(const Clock::time_point& begin, const Clock::time_point& end)
+    {
+        return std::chrono::duration<double>(end - begin).count();
+    }
+    void Wait(const club::EventPtr& event)
+    {
+        if (event)
+        {
+            event->Wait();
+        }
+    }
+    bool HigherIsBetter(const String& unit)
+    {
+        return unit.find("/s") != String::npos;
+    }
+    static cl_device_type GetDeviceType(const String& type)
+    {
+        if (type == "cpu")
+        {
+            return CL_DEVICE_TYPE_CPU;
+        }
+        if (type == "gpu")
+        {
+            return CL_DEVICE_TYPE_GPU;
+        }
+        if (type == "accelerator")
+        {
+            return CL_DEVICE_TYPE_ACCELERATOR;
+        }
+
+        return CL_DEVICE_TYPE_ALL;
+    }
+    static bool WriteJson(const String& fileName, const Results& results)
+    {
+        std::ofstream file(fileName);
+        if (!file)
+        {
+            return false;
+        }
+
+        file << "{\"results\":[\n";
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            file << (i > 0 ? ",\n" : "") << "{\"name\":\"" << results[i].name << "\",\"value\":" << results[i].value
+                << ",\"unit\":\"" << results[i].unit << "\"}";
+        }
+        file << "\n]}\n";
+
+        return static_cast<bool>(file);
+    }
+    // Reads back the files written by WriteJson, not arbitrary JSON
+    static bool ReadJson(const String& fileName, Results& results)
+    {
+        std::ifstream file(fileName);
+        std::stringstream stream;
+        std::size_t position = 0;
+
+        if (!file)
+        {
+            return false;
+        }
+
+        stream << file.rdbuf();
+        auto text = stream.str();
+
+        auto field = [&](const String& key, std::size_t from, std::size_t& end) -> String
+        {
+            auto begin = text.find("\"" + key + "\":", from);
+            if (begin == String::npos)
+            {
+                end = String::npos;
+
+                return String();
+            }
+
+            begin += key.size() + 3;
+            if (text[begin] == '"')
+            {
+                end = text.find('"', ++begin);
+            }
+            else
+            {
+                end = text.find_first_of(",}", begin);
+            }
+
+            return end == String::npos ? String() : text.substr(begin, end - begin);
+        };
+
+        while (true)
+        {
+            Result result;
+            std::size_t end;
+
+            result.name = field("name", position, end);
+            if (end == String::npos)
+            {
+                break;
+            }
+
+            result.value = std::strtod(field("value", end, end).c_str(), nullptr);
+            result.unit = field("unit", end, end);
+            if (end == String::npos)
+            {
+                break;
+            }
+
+            results.push_back(result);
+            position = end;
+        }
+
+        return true;
+    }
+    static std::size_t Compare(const Results& results, const Results& baseline, double tolerance)
+    {
+        std::map<String, Result> previous;
+        std::size_t regressions = 0;
+
+        for (const auto& it : baseline)
+        {
+            previous[it.name] = it;
+        }
+
+        for (const auto& it : results)
+        {
+            auto found = previous.find(it.name);
+            if (found == previous.end() || found->second.value <= 0.0 || found->second.unit != it.unit)
+            {
+                continue;
+            }
+
+            // Ratios above one are always improvements, whichever direction the unit favours
+            auto ratio = HigherIsBetter(it.unit) ? it.value / found->second.value : found->second.value / it.value;
+            auto regressed = ratio < 1.0 - tolerance;
+
+            regressions += regressed ? 1 : 0;
+            std::printf("%s %.6g -> %.6g %s (%+.1f%%)%s\n", it.name.c_str(), found->second.value, it.value, it.unit.c_str(),
+                (ratio - 1.0) * 100.0, regressed ? " REGRESSION" : "");
+        }
+
+        return regressions;
+    }
+} // namespace bench
+
+int main(int argc, char** argv)
+{
+    club::PlatformNumber platformNumber{ 0 };
+    club::DeviceNumber deviceNumber{ 0 };
+    club::PlatformFilter platformFilter;
+    bench::String filter;
+    bench::String jsonFile;
+    bench::String baselineFile;
+    double tolerance = 0.1;
+
+    platformFilter.print = false;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--platform") == 0)
+        {
+            platformNumber = std::strtoul(argv[i + 1], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--device") == 0)
+        {
+            deviceNumber = std::strtoul(argv[i + 1], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--vendor") == 0)
+        {
+            platformFilter.vendor = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--type") == 0)
+        {
+            platformFilter.deviceType = bench::GetDeviceType(argv[i + 1]);
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0)
+        {
+            filter = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--json") == 0)
+        {
+            jsonFile = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--baseline") == 0)
+        {
+            baselineFile = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--tolerance") == 0)
+        {
+            tolerance = std::strtod(argv[i + 1], nullptr);
+        }
+    }
+
+    // Platform and device numbers index the devices left after the vendor and type filters
+    auto platform = club::CreatePlatform(platformFilter);
+    auto context = platform ? club::CreateContext(platform, platformNumber, deviceNumber) : nullptr;
+    if (!context)
+    {
+        std::fprintf(stderr, "Could not create context %zu:%zu\n", platformNumber, deviceNumber);
+
+        return EXIT_FAILURE;
+    }
+
+    const auto& deviceInfo = context->GetDeviceInfo();
+    std::printf("# %s, %s\n", deviceInfo.name.data(), deviceInfo.version.data());
+
+    bench::Results all;
+
+    for (const auto& it : bench::GetBenchmarks())
+    {
+        bench::Results results;
+
+        if (!filter.empty() && it.first.find(filter) == bench::String::npos)
+        {
+            continue;
+        }
+
+        it.second(context, results);
+
+        for (auto& result : results)
+        {
+            result.name = it.first + "/" + result.name;
+            std::printf("%s %.6g %s\n", result.name.c_str(), result.value, result.unit.c_str());
+            all.push_back(result);
+        }
+    }
+
+    if (!jsonFile.empty() && !bench::WriteJson(jsonFile, all))
+    {
+        std::fprintf(stderr, "Could not write %s\n", jsonFile.c_str());
+
+        return EXIT_FAILURE;
+    }
+
+    if (!baselineFile.empty())
+    {
+        bench::Results baseline;
+
+        if (!bench::ReadJson(baselineFile, baseline))
+        {
+            std::fprintf(stderr, "Could not read baseline %s\n", baselineFile.c_str());
+
+            return EXIT_FAILURE;
+        }
+
+        if (bench::Compare(all, baseline, tolerance) > 0)
+        {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+#include "bench.hpp"
+
+#include <cstring>
+
+namespace bench
+{
+    static void Transfer(club::ContextPtr context, Results& results)
+    {
+        const std::size_t repetitions = 5;
+        auto pool = club::CreateStagingPool(context);
+
+        for (std::size_t size = 1 << 16; size <= (std::size_t{ 1 } << 28); size <<= 2)
+        {
+            std::vector<unsigned char> host(size, 1);
+            auto buffer = club::CreateBuffer(context, size);
+            auto pinnedBuffer = club::CreateBuffer(context, size, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR);
+            if (!buffer || !pinnedBuffer || !pool)
+            {
+                return;
+            }
+
+            // Host memory allocated by the driver stays mapped for the whole run, transfers from it need no staging copy
+            auto pinned = pinnedBuffer->Map(0, size);
+            if (!pinned)
+            {
+                return;
+            }
+
+            auto gigabytes = static_cast<double>(size) / 1e9;
+            auto suffix = std::to_string(size >> 10) + "k";
+
+            auto writePageable = Median(repetitions, [&]() { buffer->Write(0, size, host.data(), CL_TRUE); });
+            auto writePinned = Median(repetitions, [&]() { buffer->Write(0, size, pinned.Get(), CL_TRUE); });
+            auto writeStaged = Median(repetitions, [&]() { Wait(buffer->WriteStaged(pool, 0, size, host.data())); });
+            auto writeMapped = Median(repetitions, [&]()
+            {
+                auto map = buffer->Map(0, size, CL_MAP_WRITE_INVALIDATE_REGION);
+                std::memcpy(map.Get(), host.data(), size);
+                Wait(map.Unmap());
+            });
+
+            auto readPageable = Median(repetitions, [&]() { buffer->Read(0, size, host.data(), CL_TRUE); });
+            auto readPinned = Median(repetitions, [&]() { buffer->Read(0, size, pinned.Get(), CL_TRUE); });
+            auto readStaged = Median(repetitions, [&]() { buffer->ReadStaged(pool, 0, size, host.data()); });
+            auto readMapped = Median(repetitions, [&]()
+            {
+                auto map = buffer->Map(0, size, CL_MAP_READ);
+                std::memcpy(host.data(), map.Get(), size);
+                Wait(map.Unmap());
+            });
+
+            Wait(pinned.Unmap());
+
+            results.push_back({ "h2d_pageable_" + suffix, gigabytes / writePageable, "GB/s" });
+            results.push_back({ "h2d_pinned_" + suffix, gigabytes / writePinned, "GB/s" });
+            results.push_back({ "h2d_staged_" + suffix, gigabytes / writeStaged, "GB/s" });
+            results.push_back({ "h2d_mapped_" + suffix, gigabytes / writeMapped, "GB/s" });
+            results.push_back({ "d2h_pageable_" + suffix, gigabytes / readPageable, "GB/s" });
+            results.push_back({ "d2h_pinned_" + suffix, gigabytes / readPinned, "GB/s" });
+            results.push_back({ "d2h_staged_" + suffix, gigabytes / readStaged, "GB/s" });
+            results.push_back({ "d2h_mapped_" + suffix, gigabytes / readMapped, "GB/s" });
+        }
+    }
+
+    static bool registered = Register("transfer", Transfer);
+} // namespace bench
@@ -1,8 +1,22 @@
 -- premake5.lua
+newoption {
+   trigger = "no-instrumentation",
+   description = "Compile the counters, latency probes and trace hooks away"
+}
+
 workspace "club"
    configurations { "Debug", "Release" }
    location "build"
 
+   -- Defined once for every project, the value changes the layout of club::Counters and club::Probe
+   filter "options:no-instrumentation"
+      defines { "CLUB_INSTRUMENTATION=0" }
+
+   filter "options:not no-instrumentation"
+      defines { "CLUB_INSTRUMENTATION=1" }
+
+   filter {}
+
 project "club"
    kind "StaticLib"
    language "C++"
@@ -23,4 +37,35 @@ project "club"
    filter "configurations:Release"
       architecture "x86_64" 	  
 	  defines { "NDEBUG" }
-      optimize "Speed"
\ No newline at end of file
+      optimize "Speed"
+
+project "club_bench"
+   kind "ConsoleApp"
+   language "C++"
+   cppdialect "C++20"
+
+   targetdir "build/%{cfg.buildcfg}"
+   includedirs { "src" }
+   includedirs { "../utils/src"}
+   includedirs { "../logger/src"}
+   includedirs { "../opencl/inc"}
+
+   libdirs { "../utils/build/%{cfg.buildcfg}" }
+   libdirs { "../logger/build/%{cfg.buildcfg}" }
+   libdirs { "../opencl/lib" }
+
+   files { "bench/**.hpp", "bench/**.cpp" }
+   links { "club", "utils", "logger", "OpenCL" }
+
+   filter "system:linux"
+      links { "pthread" }
+
+   filter "configurations:Debug"
+	  architecture "x86_64"    
+	  defines { "DEBUG" }
+      symbols "On"
+
+   filter "configurations:Release"
+      architecture "x86_64" 	  
+	  defines { "NDEBUG" }
+      optimize "Speed"
@@ -1,13 +1,25 @@
 #ifndef CLUB_HPP_
 #define CLUB_HPP_
 
+#include "club_await.hpp"
 #include "club_buffer.hpp"
+#include "club_cache.hpp"
+#include "club_command_list.hpp"
 #include "club_context.hpp"
+#include "club_counters.hpp"
+#include "club_dispatcher.hpp"
 #include "club_event.hpp"
 #include "club_kernel.hpp"
 #include "club_messages.hpp"
 #include "club_platform.hpp"
+#include "club_pool.hpp"
 #include "club_program.hpp"
+#include "club_queue.hpp"
+#include "club_selector.hpp"
+#include "club_staging.hpp"
+#include "club_stream.hpp"
+#include "club_trace.hpp"
+#include "club_tuner.hpp"
 #include "club_types.hpp"
 
 #endif /* CLUB_HPP_ */
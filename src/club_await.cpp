@@ -0,0 +1,168 @@
+#include "club_await.hpp"
+
+#include <mutex>
+
+namespace club
+{
+    namespace
+    {
+        std::mutex executorMutex;
+        Executor executor;
+
+        Error GetStatus(cl_event event)
+        {
+            cl_int status;
+            Error error;
+
+            error = clGetEventInfo(event, CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(status), &status, NULL);
+            if (error != CL_SUCCESS)
+            {
+                return error;
+            }
+
+            return status;
+        }
+    } // namespace
+
+    void SetExecutor(Executor value)
+    {
+        std::lock_guard<std::mutex> lock(executorMutex);
+
+        executor = std::move(value);
+    }
+    void Execute(Task task)
+    {
+        Executor current;
+
+        {
+            std::lock_guard<std::mutex> lock(executorMutex);
+            current = executor;
+        }
+
+        if (current)
+        {
+            current(std::move(task));
+        }
+        else
+        {
+            task();
+        }
+    }
+    EventAwaiter::EventAwaiter(EventPtr event) : event_(std::move(event))
+    {
+    }
+    bool EventAwaiter::await_ready()
+    {
+        if (!event_)
+        {
+            status_ = CL_INVALID_EVENT;
+
+            return true;
+        }
+
+        // Completed and failed commands never suspend, negative statuses are errors
+        auto status = GetStatus(event_->Get());
+        if (status <= CL_COMPLETE)
+        {
+            status_ = status;
+
+            return true;
+        }
+
+        return false;
+    }
+    bool EventAwaiter::await_suspend(std::coroutine_handle<> handle)
+    {
+        Error error;
+
+        handle_ = handle;
+
+        // The callback may resume the coroutine before this returns, so nothing is touched after registering
+        error = clSetEventCallback(event_->Get(), CL_COMPLETE, &EventAwaiter::Complete, this);
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Event callback could not be set: {}", messages.at(error)));
+
+            status_ = error;
+
+            return false;
+        }
+
+        return true;
+    }
+    Error EventAwaiter::await_resume() const
+    {
+        return status_;
+    }
+    void CL_CALLBACK EventAwaiter::Complete(cl_event, cl_int status, void* data)
+    {
+        auto awaiter = static_cast<EventAwaiter*>(data);
+        auto handle = awaiter->handle_;
+
+        awaiter->status_ = status;
+        Execute([handle]() { handle.resume(); });
+    }
+    EventsAwaiter::EventsAwaiter(std::vector<EventPtr> events) : events_(std::move(events))
+    {
+    }
+    bool EventsAwaiter::await_ready() const
+    {
+        return events_.empty();
+    }
+    bool EventsAwaiter::await_suspend(std::coroutine_handle<> handle)
+    {
+        handle_ = handle;
+
+        // The extra count keeps the callbacks from resuming before every one of them is registered
+        remaining_ = events_.size() + 1;
+
+        for (const auto& it : events_)
+        {
+            Error error = it ? clSetEventCallback(it->Get(), CL_COMPLETE, &EventsAwaiter::Complete, this) : CL_INVALID_EVENT;
+            if (error != CL_SUCCESS)
+            {
+                Fail(error);
+                Release();
+            }
+        }
+
+        return !Release();
+    }
+    Error EventsAwaiter::await_resume() const
+    {
+        return status_;
+    }
+    void CL_CALLBACK EventsAwaiter::Complete(cl_event, cl_int status, void* data)
+    {
+        auto awaiter = static_cast<EventsAwaiter*>(data);
+
+        if (status < CL_COMPLETE)
+        {
+            awaiter->Fail(status);
+        }
+
+        auto handle = awaiter->handle_;
+        if (awaiter->Release())
+        {
+            Execute([handle]() { handle.resume(); });
+        }
+    }
+    void EventsAwaiter::Fail(Error error)
+    {
+        // Only the first error is kept
+        Error expected = CL_SUCCESS;
+        status_.compare_exchange_strong(expected, error);
+    }
+    bool EventsAwaiter::Release()
+    {
+        return remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+    EventAwaiter operator co_await(const EventPtr& event)
+    {
+        return EventAwaiter(event);
+    }
+    EventsAwaiter WhenAll(std::vector<EventPtr> events)
+    {
+        return EventsAwaiter(std::move(events));
+    }
+} // namespace club
@@ -0,0 +1,58 @@
+#ifndef CLUB_AWAIT_HPP_
+#define CLUB_AWAIT_HPP_
+
+#include "club_event.hpp"
+
+#include <atomic>
+#include <coroutine>
+
+namespace club
+{
+    // Coroutines resume through the executor, by default inline on the driver callback thread
+    void SetExecutor(Executor executor);
+    void Execute(Task task);
+
+    class EventAwaiter
+    {
+    public:
+        explicit EventAwaiter(EventPtr event);
+
+        bool await_ready();
+        bool await_suspend(std::coroutine_handle<> handle);
+        Error await_resume() const;
+
+    protected:
+        static void CL_CALLBACK Complete(cl_event event, cl_int status, void* data);
+
+        EventPtr event_;
+        Error status_{ CL_SUCCESS };
+        std::coroutine_handle<> handle_;
+    };
+
+    class EventsAwaiter
+    {
+    public:
+        explicit EventsAwaiter(std::vector<EventPtr> events);
+
+        bool await_ready() const;
+        bool await_suspend(std::coroutine_handle<> handle);
+        Error await_resume() const;
+
+    protected:
+        static void CL_CALLBACK Complete(cl_event event, cl_int status, void* data);
+
+        void Fail(Error error);
+        bool Release();
+
+        std::vector<EventPtr> events_;
+        std::atomic<Error> status_{ CL_SUCCESS };
+        std::atomic<std::size_t> remaining_{ 0 };
+        std::coroutine_handle<> handle_;
+    };
+
+    // co_await yields CL_SUCCESS once the command completed, or the error it terminated with
+    EventAwaiter operator co_await(const EventPtr& event);
+    EventsAwaiter WhenAll(std::vector<EventPtr> events);
+} // namespace club
+
+#endif /* CLUB_AWAIT_HPP_ */
@@ -1,4 +1,6 @@
 #include "club_buffer.hpp"
+#include "club_staging.hpp"
+#include <cstring>
 #include <iostream>
 #include <memory>
 
@@ -8,20 +10,107 @@ namespace club
     {
         return Buffer::Create();
     }
-    BufferPtr CreateBuffer(ConstContextPtr context, std::size_t size, cl_mem_flags flags)
+    BufferPtr CreateBuffer(ConstContextPtr context, std::size_t size, cl_mem_flags flags, void* hostPtr)
     {
         auto res = Buffer::Create();
 
-        if (!res->Init(context, flags, size))
+        if (!res->Init(context, flags, size, hostPtr))
         {
             res = nullptr;
         }
 
         return res;
     }
+    BufferPtr CreateSubBuffer(ConstBufferPtr parent, std::size_t origin, std::size_t size)
+    {
+        auto res = Buffer::Create();
+
+        if (!res->Init(parent, origin, size))
+        {
+            res = nullptr;
+        }
+
+        return res;
+    }
+    BufferMap::BufferMap(ConstQueuePtr queue, ConstBufferPtr buffer, void* ptr, std::size_t size)
+        : queue_(queue), buffer_(buffer), ptr_(ptr), size_(size)
+    {
+    }
+    BufferMap::BufferMap(BufferMap&& other) noexcept
+        : queue_(std::move(other.queue_)), buffer_(std::move(other.buffer_)), ptr_(other.ptr_), size_(other.size_)
+    {
+        other.ptr_ = nullptr;
+        other.size_ = 0;
+    }
+    BufferMap::~BufferMap()
+    {
+        Unmap();
+    }
+    BufferMap& BufferMap::operator=(BufferMap&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Unmap();
+
+            queue_ = std::move(other.queue_);
+            buffer_ = std::move(other.buffer_);
+            ptr_ = other.ptr_;
+            size_ = other.size_;
+
+            other.ptr_ = nullptr;
+            other.size_ = 0;
+        }
+
+        return *this;
+    }
+    EventPtr BufferMap::Unmap(const Events& waitList)
+    {
+        EventPtr res{ nullptr };
+        cl_event event{ nullptr };
+        Error error;
+
+        if (!ptr_)
+        {
+            return res;
+        }
+
+        error = clEnqueueUnmapMemObject(queue_->Get(), buffer_->Get(), ptr_,
+            static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), &event);
+
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Error unmapping buffer: {}", messages.at(error)));
+        }
+        else
+        {
+            res = CreateEvent(event);
+        }
+
+        ptr_ = nullptr;
+        size_ = 0;
+        buffer_ = nullptr;
+        queue_ = nullptr;
+
+        return res;
+    }
+    void* BufferMap::Get() const
+    {
+        return ptr_;
+    }
+    std::size_t BufferMap::GetSize() const
+    {
+        return size_;
+    }
+    BufferMap::operator bool() const
+    {
+        return ptr_ != nullptr;
+    }
     Buffer::~Buffer()
     {
-        clReleaseMemObject(buffer_);
+        if (buffer_)
+        {
+            clReleaseMemObject(buffer_);
+        }
     }
     BufferPtr Buffer::Create()
     {
@@ -40,18 +129,29 @@ namespace club
     {
         return const_cast<Buffer*>(this)->GetPtr();
     }
-    bool Buffer::Init(ConstContextPtr context, cl_mem_flags flags, std::size_t size)
+    bool Buffer::Init(ConstContextPtr context, cl_mem_flags flags, std::size_t size, void* hostPtr)
     {
         bool res = false;
 
         if (!initialized_)
         {
-            res = Initialize(context, flags, size);
+            res = Initialize(context, flags, size, hostPtr);
         }
 
         return res;
     }
-    bool Buffer::Initialize(ConstContextPtr context, cl_mem_flags flags, std::size_t size)
+    bool Buffer::Init(ConstBufferPtr parent, std::size_t origin, std::size_t size)
+    {
+        bool res = false;
+
+        if (!initialized_)
+        {
+            res = Initialize(parent, origin, size);
+        }
+
+        return res;
+    }
+    bool Buffer::Initialize(ConstContextPtr context, cl_mem_flags flags, std::size_t size, void* hostPtr)
     {
         bool res = false;
         Error error;
@@ -60,7 +160,14 @@ namespace club
         {
             context_ = context;
             size_ = size;
-            buffer_ = clCreateBuffer(context_->Get(), flags, size_, nullptr, &error);
+
+            // Devices sharing memory with the host get zero-copy allocations, so mapping them costs no transfer
+            if (!(flags & (CL_MEM_USE_HOST_PTR | CL_MEM_ALLOC_HOST_PTR | CL_MEM_COPY_HOST_PTR)) && context_->GetDeviceInfo().hostUnifiedMemory)
+            {
+                flags |= CL_MEM_ALLOC_HOST_PTR;
+            }
+
+            buffer_ = clCreateBuffer(context_->Get(), flags, size_, hostPtr, &error);
 
             if (error != CL_SUCCESS)
             {
@@ -71,6 +178,7 @@ namespace club
             {
                 bufferInfo_ = GetBufferInfo(buffer_);
                 initialized_ = true;
+                context_->GetCounters().Add(Counter::BuffersCreated);
 
                 res = true;
             }
@@ -82,44 +190,502 @@ namespace club
 
         return res;
     }
-    EventPtr Buffer::Read(std::size_t offset, std::size_t size, void* ptr, cl_bool block)
+    bool Buffer::Initialize(ConstBufferPtr parent, std::size_t origin, std::size_t size)
+    {
+        bool res = false;
+        Error error;
+
+        if (parent != nullptr)
+        {
+            cl_buffer_region region{ origin, size };
+
+            buffer_ = clCreateSubBuffer(parent->Get(), 0, CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
+
+            if (error != CL_SUCCESS)
+            {
+                logger::Error(header, utils::string::Format("Sub-buffer could not be created: {}", messages.at(error)));
+
+                buffer_ = nullptr;
+            }
+            else
+            {
+                context_ = parent->GetContextPtr();
+                parent_ = parent;
+                origin_ = origin;
+                size_ = size;
+                bufferInfo_ = GetBufferInfo(buffer_);
+                initialized_ = true;
+
+                res = true;
+            }
+        }
+        else
+        {
+            logger::Error(header, "Sub-buffer not created: parent pointer is null");
+        }
+
+        return res;
+    }
+    EventPtr Buffer::Read(std::size_t offset, std::size_t size, void* ptr, cl_bool block, const Events& waitList)
+    {
+        return Read(context_->GetQueuePtr(), offset, size, ptr, block, waitList);
+    }
+    EventPtr Buffer::Read(ConstQueuePtr queue, std::size_t offset, std::size_t size, void* ptr, cl_bool block, const Events& waitList)
     {
         EventPtr res {nullptr};
-        cl_event event;
+        cl_event event{ nullptr };
         Error error;
+        Probe probe(context_->GetCounters(), Latency::Read);
+
+        if (!queue)
+        {
+            logger::Error(header, "Error reading buffer: queue pointer is null");
+
+            return res;
+        }
 
-        error = clEnqueueReadBuffer(context_->GetQueue(), buffer_, block, offset, size, ptr, 0, NULL, &event);
+        cl_event* slot = queue->GetEventSlot(event);
+
+        error = clEnqueueReadBuffer(queue->Get(), buffer_, block, offset, size, ptr,
+            static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), slot);
 
         if (error != CL_SUCCESS)
         {
+            queue->SetLastError(error);
             logger::Error(header, utils::string::Format("Error reading buffer: {}", messages.at(error)));
         }
         else
         {
-            res = CreateEvent(event);
+            context_->GetCounters().Add(Counter::EnqueueRead);
+            context_->GetCounters().Add(Counter::BytesRead, size);
+            probe.SetCommand(queue->Get(), event, size);
+            res = queue->WrapEvent(slot);
         }
 
         return res;
     }
-    EventPtr Buffer::Write(std::size_t offset, std::size_t size, const void* ptr, cl_bool block)
+    EventPtr Buffer::Write(std::size_t offset, std::size_t size, const void* ptr, cl_bool block, const Events& waitList)
+    {
+        return Write(context_->GetQueuePtr(), offset, size, ptr, block, waitList);
+    }
+    EventPtr Buffer::Write(ConstQueuePtr queue, std::size_t offset, std::size_t size, const void* ptr, cl_bool block, const Events& waitList)
     {
         EventPtr res {nullptr};
-        cl_event event;
+        cl_event event{ nullptr };
         Error error;
+        Probe probe(context_->GetCounters(), Latency::Write);
 
-        error = clEnqueueWriteBuffer(context_->GetQueue(), buffer_, block, offset, size, ptr, 0, NULL, &event);
+        if (!queue)
+        {
+            logger::Error(header, "Error writing buffer: queue pointer is null");
+
+            return res;
+        }
+
+        cl_event* slot = queue->GetEventSlot(event);
+
+        error = clEnqueueWriteBuffer(queue->Get(), buffer_, block, offset, size, ptr,
+            static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), slot);
 
         if (error != CL_SUCCESS)
         {
+            queue->SetLastError(error);
             logger::Error(header, utils::string::Format("Error writing buffer: {}", messages.at(error)));
         }
         else
         {
-            res = CreateEvent(event);
+            context_->GetCounters().Add(Counter::EnqueueWrite);
+            context_->GetCounters().Add(Counter::BytesWritten, size);
+            probe.SetCommand(queue->Get(), event, size);
+            res = queue->WrapEvent(slot);
         }
 
         return res;
     }
+    EventPtr Buffer::ReadRect(const RectLayout& bufferLayout, const RectLayout& hostLayout, const Region& region, void* ptr, cl_bool block, const Events& waitList)
+    {
+        return ReadRect(context_->GetQueuePtr(), bufferLayout, hostLayout, region, ptr, block, waitList);
+    }
+    EventPtr Buffer::ReadRect(ConstQueuePtr queue, const RectLayout& bufferLayout, const RectLayout& hostLayout, const Region& region, void* ptr, cl_bool block, const Events& waitList)
+    {
+        EventPtr res{ nullptr };
+        cl_event event{ nullptr };
+        Error error;
+        Probe probe(context_->GetCounters(), Latency::Read);
+
+        if (!queue)
+        {
+            logger::Error(header, "Error reading buffer rectangle: queue pointer is null");
+
+            return res;
+        }
+
+        cl_event* slot = queue->GetEventSlot(event);
+
+        error = clEnqueueReadBufferRect(queue->Get(), buffer_, block, bufferLayout.origin.data(), hostLayout.origin.data(), region.data(),
+            bufferLayout.rowPitch, bufferLayout.slicePitch, hostLayout.rowPitch, hostLayout.slicePitch, ptr,
+            static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), slot);
+
+        if (error != CL_SUCCESS)
+        {
+            queue->SetLastError(error);
+            logger::Error(header, utils::string::Format("Error reading buffer rectangle: {}", messages.at(error)));
+        }
+        else
+        {
+            context_->GetCounters().Add(Counter::EnqueueRead);
+            context_->GetCounters().Add(Counter::BytesRead, region[0] * region[1] * region[2]);
+            probe.SetCommand(queue->Get(), event, region[0] * region[1] * region[2]);
+            res = queue->WrapEvent(slot);
+        }
+
+        return res;
+    }
+    EventPtr Buffer::WriteRect(const RectLayout& bufferLayout, const RectLayout& hostLayout, const Region& region, const void* ptr, cl_bool block, const Events& waitList)
+    {
+        return WriteRect(context_->GetQueuePtr(), bufferLayout, hostLayout, region, ptr, block, waitList);
+    }
+    EventPtr Buffer::WriteRect(ConstQueuePtr queue, const RectLayout& bufferLayout, const RectLayout& hostLayout, const Region& region, const void* ptr, cl_bool block, const Events& waitList)
+    {
+        EventPtr res{ nullptr };
+        cl_event event{ nullptr };
+        Error error;
+        Probe probe(context_->GetCounters(), Latency::Write);
+
+        if (!queue)
+        {
+            logger::Error(header, "Error writing buffer rectangle: queue pointer is null");
+
+            return res;
+        }
+
+        cl_event* slot = queue->GetEventSlot(event);
+
+        error = clEnqueueWriteBufferRect(queue->Get(), buffer_, block, bufferLayout.origin.data(), hostLayout.origin.data(), region.data(),
+            bufferLayout.rowPitch, bufferLayout.slicePitch, hostLayout.rowPitch, hostLayout.slicePitch, ptr,
+            static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), slot);
+
+        if (error != CL_SUCCESS)
+        {
+            queue->SetLastError(error);
+            logger::Error(header, utils::string::Format("Error writing buffer rectangle: {}", messages.at(error)));
+        }
+        else
+        {
+            context_->GetCounters().Add(Counter::EnqueueWrite);
+            context_->GetCounters().Add(Counter::BytesWritten, region[0] * region[1] * region[2]);
+            probe.SetCommand(queue->Get(), event, region[0] * region[1] * region[2]);
+            res = queue->WrapEvent(slot);
+        }
+
+        return res;
+    }
+    EventPtr Buffer::CopyRect(ConstBufferPtr dst, const RectLayout& srcLayout, const RectLayout& dstLayout, const Region& region, const Events& waitList)
+    {
+        return CopyRect(context_->GetQueuePtr(), dst, srcLayout, dstLayout, region, waitList);
+    }
+    EventPtr Buffer::CopyRect(ConstQueuePtr queue, ConstBufferPtr dst, const RectLayout& srcLayout, const RectLayout& dstLayout, const Region& region, const Events& waitList)
+    {
+        EventPtr res{ nullptr };
+        cl_event event{ nullptr };
+        Error error;
+        Probe probe(context_->GetCounters(), Latency::Copy);
+
+        if (!queue || !dst)
+        {
+            logger::Error(header, "Error copying buffer rectangle: queue or destination pointer is null");
+
+            return res;
+        }
+
+        cl_event* slot = queue->GetEventSlot(event);
+
+        error = clEnqueueCopyBufferRect(queue->Get(), buffer_, dst->Get(), srcLayout.origin.data(), dstLayout.origin.data(), region.data(),
+            srcLayout.rowPitch, srcLayout.slicePitch, dstLayout.rowPitch, dstLayout.slicePitch,
+            static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), slot);
+
+        if (error != CL_SUCCESS)
+        {
+            queue->SetLastError(error);
+            logger::Error(header, utils::string::Format("Error copying buffer rectangle: {}", messages.at(error)));
+        }
+        else
+        {
+            context_->GetCounters().Add(Counter::EnqueueCopy);
+            context_->GetCounters().Add(Counter::BytesCopied, region[0] * region[1] * region[2]);
+            probe.SetCommand(queue->Get(), event, region[0] * region[1] * region[2]);
+            res = queue->WrapEvent(slot);
+        }
+
+        return res;
+    }
+    EventPtr Buffer::CopyTo(ConstBufferPtr dst, std::size_t srcOffset, std::size_t dstOffset, std::size_t size, const Events& waitList)
+    {
+        return CopyTo(context_->GetQueuePtr(), dst, srcOffset, dstOffset, size, waitList);
+    }
+    EventPtr Buffer::CopyTo(ConstQueuePtr queue, ConstBufferPtr dst, std::size_t srcOffset, std::size_t dstOffset, std::size_t size, const Events& waitList)
+    {
+        EventPtr res{ nullptr };
+        cl_event event{ nullptr };
+        Error error;
+        Probe probe(context_->GetCounters(), Latency::Copy);
+
+        if (!queue || !dst)
+        {
+            logger::Error(header, "Error copying buffer: queue or destination pointer is null");
+
+            return res;
+        }
+
+        cl_event* slot = queue->GetEventSlot(event);
+
+        error = clEnqueueCopyBuffer(queue->Get(), buffer_, dst->Get(), srcOffset, dstOffset, size,
+            static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), slot);
+
+        if (error != CL_SUCCESS)
+        {
+            queue->SetLastError(error);
+            logger::Error(header, utils::string::Format("Error copying buffer: {}", messages.at(error)));
+        }
+        else
+        {
+            context_->GetCounters().Add(Counter::EnqueueCopy);
+            context_->GetCounters().Add(Counter::BytesCopied, size);
+            probe.SetCommand(queue->Get(), event, size);
+            res = queue->WrapEvent(slot);
+        }
+
+        return res;
+    }
+    EventPtr Buffer::Fill(const void* pattern, std::size_t patternSize, std::size_t offset, std::size_t size, const Events& waitList)
+    {
+        return Fill(context_->GetQueuePtr(), pattern, patternSize, offset, size, waitList);
+    }
+    EventPtr Buffer::Fill(ConstQueuePtr queue, const void* pattern, std::size_t patternSize, std::size_t offset, std::size_t size, const Events& waitList)
+    {
+        EventPtr res{ nullptr };
+        cl_event event{ nullptr };
+        Error error;
+        Probe probe(context_->GetCounters(), Latency::Fill);
+
+        if (!queue)
+        {
+            logger::Error(header, "Error filling buffer: queue pointer is null");
+
+            return res;
+        }
+
+        cl_event* slot = queue->GetEventSlot(event);
+
+        error = clEnqueueFillBuffer(queue->Get(), buffer_, pattern, patternSize, offset, size,
+            static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), slot);
+
+        if (error != CL_SUCCESS)
+        {
+            queue->SetLastError(error);
+            logger::Error(header, utils::string::Format("Error filling buffer: {}", messages.at(error)));
+        }
+        else
+        {
+            context_->GetCounters().Add(Counter::EnqueueFill);
+            probe.SetCommand(queue->Get(), event, size);
+            res = queue->WrapEvent(slot);
+        }
+
+        return res;
+    }
+    EventPtr Buffer::ReadStaged(StagingPoolPtr pool, std::size_t offset, std::size_t size, void* ptr, const Events& waitList)
+    {
+        return ReadStaged(context_->GetQueuePtr(), pool, offset, size, ptr, waitList);
+    }
+    EventPtr Buffer::ReadStaged(ConstQueuePtr queue, StagingPoolPtr pool, std::size_t offset, std::size_t size, void* ptr, const Events& waitList)
+    {
+        EventPtr res{ nullptr };
+        cl_event event{ nullptr };
+        Error error;
+        Probe probe(context_->GetCounters(), Latency::Read);
+
+        if (!queue || !pool)
+        {
+            logger::Error(header, "Error reading staged buffer: queue or staging pool pointer is null");
+
+            return res;
+        }
+
+        if (pool->GetChunkSize() == 0 || pool->GetNumberChunks() == 0)
+        {
+            logger::Error(header, "Error reading staged buffer: staging pool is not initialized");
+
+            return res;
+        }
+
+        // Nothing to transfer, the caller still gets an event ordered after its wait list
+        if (size == 0)
+        {
+            res = queue->EnqueueMarker(waitList);
+            if (res)
+            {
+                res->Wait();
+            }
+
+            return res;
+        }
+
+        std::lock_guard<std::mutex> lock(pool->mutex_);
+        auto chunkSize = pool->GetChunkSize();
+        auto numberChunks = (size + chunkSize - 1) / chunkSize;
+        auto depth = pool->GetNumberChunks();
+        auto dst = static_cast<unsigned char*>(ptr);
+
+        // Keep up to depth chunks in flight, copying chunk N out while the following ones are still transferring
+        for (Index i = 0; i < numberChunks + depth; ++i)
+        {
+            if (i >= depth)
+            {
+                auto chunk = i - depth;
+                auto& slot = pool->Acquire(chunk);
+                auto length = std::min(chunkSize, size - chunk * chunkSize);
+
+                std::memcpy(dst + chunk * chunkSize, slot.map.Get(), length);
+            }
+
+            if (i < numberChunks)
+            {
+                auto& slot = pool->Acquire(i);
+                auto length = std::min(chunkSize, size - i * chunkSize);
+
+                error = clEnqueueReadBuffer(queue->Get(), buffer_, CL_FALSE, offset + i * chunkSize, length, slot.map.Get(),
+                    static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), &event);
+
+                if (error != CL_SUCCESS)
+                {
+                    logger::Error(header, utils::string::Format("Error reading staged buffer: {}", messages.at(error)));
+                    queue->Finish();
+
+                    return nullptr;
+                }
+
+                slot.pending = CreateEvent(event);
+                res = slot.pending;
+                queue->Flush();
+            }
+        }
+
+        context_->GetCounters().Add(Counter::EnqueueRead);
+        context_->GetCounters().Add(Counter::BytesRead, size);
+        probe.SetCommand(queue->Get(), nullptr, size);
+
+        return res;
+    }
+    EventPtr Buffer::WriteStaged(StagingPoolPtr pool, std::size_t offset, std::size_t size, const void* ptr, const Events& waitList)
+    {
+        return WriteStaged(context_->GetQueuePtr(), pool, offset, size, ptr, waitList);
+    }
+    EventPtr Buffer::WriteStaged(ConstQueuePtr queue, StagingPoolPtr pool, std::size_t offset, std::size_t size, const void* ptr, const Events& waitList)
+    {
+        EventPtr res{ nullptr };
+        cl_event event{ nullptr };
+        Error error;
+        Probe probe(context_->GetCounters(), Latency::Write);
+
+        if (!queue || !pool)
+        {
+            logger::Error(header, "Error writing staged buffer: queue or staging pool pointer is null");
+
+            return res;
+        }
+
+        if (pool->GetChunkSize() == 0 || pool->GetNumberChunks() == 0)
+        {
+            logger::Error(header, "Error writing staged buffer: staging pool is not initialized");
+
+            return res;
+        }
+
+        // Nothing to transfer, the caller still gets an event ordered after its wait list
+        if (size == 0)
+        {
+            return queue->EnqueueMarker(waitList);
+        }
+
+        std::lock_guard<std::mutex> lock(pool->mutex_);
+        auto chunkSize = pool->GetChunkSize();
+        auto numberChunks = (size + chunkSize - 1) / chunkSize;
+        auto src = static_cast<const unsigned char*>(ptr);
+        std::vector<EventPtr> chunks;
+
+        chunks.reserve(numberChunks);
+
+        // Copying chunk N + 1 into pinned memory overlaps with the transfer of chunk N
+        for (Index i = 0; i < numberChunks; ++i)
+        {
+            auto& slot = pool->Acquire(i);
+            auto length = std::min(chunkSize, size - i * chunkSize);
+
+            std::memcpy(slot.map.Get(), src + i * chunkSize, length);
+
+            error = clEnqueueWriteBuffer(queue->Get(), buffer_, CL_FALSE, offset + i * chunkSize, length, slot.map.Get(),
+                static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), &event);
+
+            if (error != CL_SUCCESS)
+            {
+                logger::Error(header, utils::string::Format("Error writing staged buffer: {}", messages.at(error)));
+                queue->Finish();
+
+                return nullptr;
+            }
+
+            slot.pending = CreateEvent(event);
+            chunks.push_back(slot.pending);
+            queue->Flush();
+        }
+
+        // Chunks may complete out of order on out-of-order queues, the marker covers all of them
+        res = queue->EnqueueMarker(GetEvents(chunks));
+
+        if (!res)
+        {
+            return res;
+        }
+
+        context_->GetCounters().Add(Counter::EnqueueWrite);
+        context_->GetCounters().Add(Counter::BytesWritten, size);
+        probe.SetCommand(queue->Get(), nullptr, size);
+
+        return res;
+    }
+    BufferMap Buffer::Map(std::size_t offset, std::size_t size, cl_map_flags flags, const Events& waitList)
+    {
+        return Map(context_->GetQueuePtr(), offset, size, flags, waitList);
+    }
+    BufferMap Buffer::Map(ConstQueuePtr queue, std::size_t offset, std::size_t size, cl_map_flags flags, const Events& waitList)
+    {
+        void* ptr;
+        Error error;
+        Probe probe(context_->GetCounters(), Latency::Map);
+
+        if (!queue)
+        {
+            logger::Error(header, "Error mapping buffer: queue pointer is null");
+
+            return BufferMap();
+        }
+
+        ptr = clEnqueueMapBuffer(queue->Get(), buffer_, CL_TRUE, flags, offset, size,
+            static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), NULL, &error);
+
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Error mapping buffer: {}", messages.at(error)));
+
+            return BufferMap();
+        }
+
+        context_->GetCounters().Add(Counter::EnqueueMap);
+        probe.SetCommand(queue->Get(), nullptr, size);
+
+        return BufferMap(queue, GetPtr(), ptr, size);
+    }
     const cl_mem& Buffer::Get() const
     {
         return buffer_;
@@ -128,10 +694,42 @@ namespace club
     {
         return context_->Get();
     }
+    ConstContextPtr Buffer::GetContextPtr() const
+    {
+        return context_;
+    }
+    ConstBufferPtr Buffer::GetParent() const
+    {
+        return parent_;
+    }
     const BufferInfo& Buffer::GetInfo() const
     {
         return bufferInfo_;
     }
+    std::size_t Buffer::GetSize() const
+    {
+        return size_;
+    }
+    std::size_t Buffer::GetOrigin() const
+    {
+        return origin_;
+    }
+    bool Buffer::IsHostMemory() const
+    {
+        return (bufferInfo_.flags & (CL_MEM_USE_HOST_PTR | CL_MEM_ALLOC_HOST_PTR)) != 0;
+    }
+    bool Buffer::IsRectView(std::size_t stride) const
+    {
+        // Rectangular transfers copy whole rows, elements spread over a row cannot be expressed with pitches
+        if (stride != 1)
+        {
+            logger::Error(header, utils::string::Format("Error transferring view: innermost stride is {}, rows must be contiguous", stride));
+
+            return false;
+        }
+
+        return true;
+    }
     BufferInfo Buffer::GetBufferInfo(cl_mem arg1) const
     {
         BufferInfo res;
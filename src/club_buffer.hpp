@@ -7,7 +7,88 @@
 namespace club
 {
     BufferPtr CreateBuffer();
-    BufferPtr CreateBuffer(ConstContextPtr context, std::size_t size, cl_mem_flags flags = CL_MEM_READ_WRITE);
+    BufferPtr CreateBuffer(ConstContextPtr context, std::size_t size, cl_mem_flags flags = CL_MEM_READ_WRITE, void* hostPtr = nullptr);
+    BufferPtr CreateSubBuffer(ConstBufferPtr parent, std::size_t origin, std::size_t size);
+
+    template <typename View>
+    concept StridedView = requires(const View& view) {
+        typename View::element_type;
+        view.data_handle();
+        view.extent(0);
+        view.stride(0);
+        View::rank();
+    };
+
+    // Layout and region of a row-major strided host view (std::mdspan or alike), x is the fastest dimension in bytes
+    // Rows must be contiguous, views with a non unit innermost stride are rejected by ReadRect/WriteRect
+    template <StridedView View> RectLayout GetRectLayout(const View& view)
+    {
+        constexpr auto rank = View::rank();
+        constexpr auto bytes = sizeof(typename View::element_type);
+        RectLayout res{ { 0, 0, 0 }, 0, 0 };
+
+        static_assert(rank >= 1 && rank <= 3, "Rectangular transfers support views of rank 1 to 3");
+
+        if constexpr (rank > 1)
+        {
+            res.rowPitch = view.stride(rank - 2) * bytes;
+        }
+        if constexpr (rank > 2)
+        {
+            res.slicePitch = view.stride(rank - 3) * bytes;
+        }
+
+        return res;
+    }
+    template <StridedView View> Region GetRectRegion(const View& view)
+    {
+        constexpr auto rank = View::rank();
+        constexpr auto bytes = sizeof(typename View::element_type);
+        Region res{ view.extent(rank - 1) * bytes, 1, 1 };
+
+        if constexpr (rank > 1)
+        {
+            res[1] = view.extent(rank - 2);
+        }
+        if constexpr (rank > 2)
+        {
+            res[2] = view.extent(rank - 3);
+        }
+
+        return res;
+    }
+
+    class BufferMap
+    {
+    public:
+        BufferMap() = default;
+        BufferMap(ConstQueuePtr queue, ConstBufferPtr buffer, void* ptr, std::size_t size);
+        BufferMap(const BufferMap&) = delete;
+        BufferMap(BufferMap&& other) noexcept;
+        ~BufferMap();
+
+        BufferMap& operator=(const BufferMap&) = delete;
+        BufferMap& operator=(BufferMap&& other) noexcept;
+
+        EventPtr Unmap(const Events& waitList = {});
+
+        void* Get() const;
+        std::size_t GetSize() const;
+
+        template <typename T> T* Data() const
+        {
+            return static_cast<T*>(ptr_);
+        }
+
+        explicit operator bool() const;
+
+    protected:
+        ConstQueuePtr queue_{ nullptr };
+        ConstBufferPtr buffer_{ nullptr };
+
+        void* ptr_{ nullptr };
+        std::size_t size_{ 0 };
+    };
 
     class Buffer : public std::enable_shared_from_this<Buffer>
     {
@@ -18,22 +99,82 @@ namespace club
         BufferPtr GetPtr();
         ConstBufferPtr GetPtr() const;
 
-        bool Init(ConstContextPtr context, cl_mem_flags flags, std::size_t size);
+        bool Init(ConstContextPtr context, cl_mem_flags flags, std::size_t size, void* hostPtr = nullptr);
+        bool Init(ConstBufferPtr parent, std::size_t origin, std::size_t size);
+
+        EventPtr Read(std::size_t offset, std::size_t size, void* ptr, cl_bool block = CL_FALSE, const Events& waitList = {});
+        EventPtr Read(ConstQueuePtr queue, std::size_t offset, std::size_t size, void* ptr, cl_bool block = CL_FALSE, const Events& waitList = {});
+        EventPtr Write(std::size_t offset, std::size_t size, const void* ptr, cl_bool block = CL_FALSE, const Events& waitList = {});
+        EventPtr Write(ConstQueuePtr queue, std::size_t offset, std::size_t size, const void* ptr, cl_bool block = CL_FALSE, const Events& waitList = {});
+
+        EventPtr ReadRect(const RectLayout& bufferLayout, const RectLayout& hostLayout, const Region& region, void* ptr, cl_bool block = CL_FALSE, const Events& waitList = {});
+        EventPtr ReadRect(ConstQueuePtr queue, const RectLayout& bufferLayout, const RectLayout& hostLayout, const Region& region, void* ptr, cl_bool block = CL_FALSE, const Events& waitList = {});
+        EventPtr WriteRect(const RectLayout& bufferLayout, const RectLayout& hostLayout, const Region& region, const void* ptr, cl_bool block = CL_FALSE, const Events& waitList = {});
+        EventPtr WriteRect(ConstQueuePtr queue, const RectLayout& bufferLayout, const RectLayout& hostLayout, const Region& region, const void* ptr, cl_bool block = CL_FALSE, const Events& waitList = {});
+        EventPtr CopyRect(ConstBufferPtr dst, const RectLayout& srcLayout, const RectLayout& dstLayout, const Region& region, const Events& waitList = {});
+        EventPtr CopyRect(ConstQueuePtr queue, ConstBufferPtr dst, const RectLayout& srcLayout, const RectLayout& dstLayout, const Region& region, const Events& waitList = {});
+
+        template <StridedView View> EventPtr ReadRect(const RectLayout& bufferLayout, const View& view, cl_bool block = CL_FALSE, const Events& waitList = {})
+        {
+            if (!IsRectView(view.stride(View::rank() - 1)))
+            {
+                return nullptr;
+            }
+
+            return ReadRect(bufferLayout, GetRectLayout(view), GetRectRegion(view), view.data_handle(), block, waitList);
+        }
+        template <StridedView View> EventPtr WriteRect(const RectLayout& bufferLayout, const View& view, cl_bool block = CL_FALSE, const Events& waitList = {})
+        {
+            if (!IsRectView(view.stride(View::rank() - 1)))
+            {
+                return nullptr;
+            }
+
+            return WriteRect(bufferLayout, GetRectLayout(view), GetRectRegion(view), view.data_handle(), block, waitList);
+        }
+
+        EventPtr CopyTo(ConstBufferPtr dst, std::size_t srcOffset, std::size_t dstOffset, std::size_t size, const Events& waitList = {});
+        EventPtr CopyTo(ConstQueuePtr queue, ConstBufferPtr dst, std::size_t srcOffset, std::size_t dstOffset, std::size_t size, const Events& waitList = {});
+        EventPtr Fill(const void* pattern, std::size_t patternSize, std::size_t offset, std::size_t size, const Events& waitList = {});
+        EventPtr Fill(ConstQueuePtr queue, const void* pattern, std::size_t patternSize, std::size_t offset, std::size_t size, const Events& waitList = {});
+
+        template <typename T> requires (std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>) EventPtr Fill(const T& pattern, std::size_t offset, std::size_t size, const Events& waitList = {})
+        {
+            return Fill(&pattern, sizeof(T), offset, size, waitList);
+        }
+        template <typename T> requires (std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>) EventPtr Fill(ConstQueuePtr queue, const T& pattern, std::size_t offset, std::size_t size, const Events& waitList = {})
+        {
+            return Fill(queue, &pattern, sizeof(T), offset, size, waitList);
+        }
+
+        // Staged reads are synchronous: ptr holds the data on return and the returned event is already complete
+        // Staged writes return a marker over every chunk, ptr can be reused on return
+        EventPtr ReadStaged(StagingPoolPtr pool, std::size_t offset, std::size_t size, void* ptr, const Events& waitList = {});
+        EventPtr ReadStaged(ConstQueuePtr queue, StagingPoolPtr pool, std::size_t offset, std::size_t size, void* ptr, const Events& waitList = {});
+        EventPtr WriteStaged(StagingPoolPtr pool, std::size_t offset, std::size_t size, const void* ptr, const Events& waitList = {});
+        EventPtr WriteStaged(ConstQueuePtr queue, StagingPoolPtr pool, std::size_t offset, std::size_t size, const void* ptr, const Events& waitList = {});
 
-        EventPtr Read(std::size_t offset, std::size_t size, void* ptr, cl_bool block = CL_FALSE);
-        EventPtr Write(std::size_t offset, std::size_t size, const void* ptr, cl_bool block = CL_FALSE);
+        BufferMap Map(std::size_t offset, std::size_t size, cl_map_flags flags = CL_MAP_READ | CL_MAP_WRITE, const Events& waitList = {});
+        BufferMap Map(ConstQueuePtr queue, std::size_t offset, std::size_t size, cl_map_flags flags = CL_MAP_READ | CL_MAP_WRITE, const Events& waitList = {});
         
         const cl_mem& Get() const;
         const cl_context& GetContext() const;
+        ConstContextPtr GetContextPtr() const;
+        ConstBufferPtr GetParent() const;
 
         const BufferInfo& GetInfo() const;
+        std::size_t GetSize() const;
+        std::size_t GetOrigin() const;
+        bool IsHostMemory() const;
 
     protected:
         Buffer() = default;
 
-        bool Initialize(ConstContextPtr context, cl_mem_flags flags, std::size_t size);
+        bool Initialize(ConstContextPtr context, cl_mem_flags flags, std::size_t size, void* hostPtr);
+        bool Initialize(ConstBufferPtr parent, std::size_t origin, std::size_t size);
 
         BufferInfo GetBufferInfo(cl_mem arg1) const;
+        bool IsRectView(std::size_t stride) const;
 
         template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type GetBufferInfo(cl_mem buffer, cl_mem_info info) const;
         template <typename T> typename std::enable_if<is_vector<T>::value, T>::type GetBufferInfo(cl_mem buffer, cl_mem_info info) const;
@@ -41,9 +182,11 @@ namespace club
         bool initialized_{ false };
 
         ConstContextPtr context_{ nullptr };
+        ConstBufferPtr parent_{ nullptr };
+        std::size_t origin_{ 0 };
         std::size_t size_{ 0 };
 
-        cl_mem buffer_;
+        cl_mem buffer_{ nullptr };
         BufferInfo bufferInfo_;
     };
 } // namespace club
@@ -0,0 +1,147 @@
+#include "club_cache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace club
+{
+    static std::mutex cacheMutex;
+    static String cacheDirectory = std::getenv("CLUB_CACHE_DIR") ? std::getenv("CLUB_CACHE_DIR") : "";
+
+    Hash HashCombine(const Hash& seed, const void* data, std::size_t size)
+    {
+        auto bytes = static_cast<const unsigned char*>(data);
+        Hash res = seed;
+
+        // FNV-1a, the size is mixed in as well so that consecutive fields cannot alias
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            res = (res ^ bytes[i]) * 1099511628211ull;
+        }
+
+        for (std::size_t i = 0; i < sizeof(size); ++i)
+        {
+            res = (res ^ ((size >> (8 * i)) & 0xff)) * 1099511628211ull;
+        }
+
+        return res;
+    }
+    Hash HashCombine(const Hash& seed, const String& value)
+    {
+        return HashCombine(seed, value.data(), value.size());
+    }
+    String HashToString(const Hash& hash)
+    {
+        static const char digits[] = "0123456789abcdef";
+        String res(16, '0');
+
+        for (std::size_t i = 0; i < 16; ++i)
+        {
+            res[15 - i] = digits[(hash >> (4 * i)) & 0xf];
+        }
+
+        return res;
+    }
+    void SetCacheDirectory(const String& directory)
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+
+        cacheDirectory = directory;
+    }
+    String GetCacheDirectory()
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+
+        return cacheDirectory;
+    }
+    bool LoadFile(const String& path, Binary& data)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return false;
+        }
+
+        data.resize(static_cast<std::size_t>(file.tellg()));
+        file.seekg(0);
+
+        if (data.empty() || !file.read(reinterpret_cast<char*>(data.data()), data.size()))
+        {
+            data.clear();
+
+            return false;
+        }
+
+        return true;
+    }
+    bool StoreFile(const String& path, const Binary& data)
+    {
+        static std::atomic<std::size_t> counter{ 0 };
+        std::error_code error;
+
+        std::filesystem::path target(path);
+        if (target.has_parent_path())
+        {
+            std::filesystem::create_directories(target.parent_path(), error);
+        }
+
+        // Write to a unique temporary file and rename it into place, readers never see partial entries
+        // The random part keeps processes sharing the directory from writing to the same temporary file
+        thread_local std::random_device device;
+        auto unique = (static_cast<Hash>(device()) << 32 | device()) ^ std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+            static_cast<Hash>(std::chrono::steady_clock::now().time_since_epoch().count());
+        std::filesystem::path temporary = target;
+        temporary += utils::string::Format(".{}.{}.tmp", HashToString(unique), counter++);
+
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file || !file.write(reinterpret_cast<const char*>(data.data()), data.size()))
+            {
+                logger::Error(header, utils::string::Format("Could not write file {}", temporary.string()));
+                file.close();
+                std::filesystem::remove(temporary, error);
+
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary, target, error);
+        if (error)
+        {
+            logger::Error(header, utils::string::Format("Could not store file {}: {}", target.string(), error.message()));
+            std::filesystem::remove(temporary, error);
+
+            return false;
+        }
+
+        return true;
+    }
+    bool LoadCache(const String& name, Binary& data)
+    {
+        auto directory = GetCacheDirectory();
+
+        if (directory.empty())
+        {
+            return false;
+        }
+
+        return LoadFile((std::filesystem::path(directory) / name).string(), data);
+    }
+    bool StoreCache(const String& name, const Binary& data)
+    {
+        auto directory = GetCacheDirectory();
+
+        if (directory.empty())
+        {
+            return false;
+        }
+
+        return StoreFile((std::filesystem::path(directory) / name).string(), data);
+    }
+} // namespace club
@@ -0,0 +1,23 @@
+#ifndef CLUB_CACHE_HPP_
+#define CLUB_CACHE_HPP_
+
+#include "club_types.hpp"
+
+namespace club
+{
+    Hash HashCombine(const Hash& seed, const void* data, std::size_t size);
+    Hash HashCombine(const Hash& seed, const String& value);
+    String HashToString(const Hash& hash);
+
+    void SetCacheDirectory(const String& directory);
+    String GetCacheDirectory();
+
+    // Whole file access, stores write a temporary file and rename it so that readers never see partial content
+    bool LoadFile(const String& path, Binary& data);
+    bool StoreFile(const String& path, const Binary& data);
+
+    bool LoadCache(const String& name, Binary& data);
+    bool StoreCache(const String& name, const Binary& data);
+} // namespace club
+
+#endif
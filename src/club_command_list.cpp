@@ -0,0 +1,538 @@
+#include "club_command_list.hpp"
+
+#include <algorithm>
+
+#ifdef cl_khr_command_buffer
+// Version 0.9.5 of the extension added a properties argument to the recorded commands
+#if defined(CL_KHR_COMMAND_BUFFER_EXTENSION_VERSION)
+#if CL_KHR_COMMAND_BUFFER_EXTENSION_VERSION >= CL_MAKE_VERSION(0, 9, 5)
+#define CLUB_COMMAND_PROPERTIES NULL,
+#endif
+#endif
+#ifndef CLUB_COMMAND_PROPERTIES
+#define CLUB_COMMAND_PROPERTIES
+#endif
+#endif
+
+namespace club
+{
+    namespace
+    {
+        // Extension error codes are not in the messages table
+        String GetErrorMessage(Error error)
+        {
+            auto it = messages.find(error);
+
+            return it != messages.end() ? it->second : std::to_string(error);
+        }
+    } // namespace
+
+    CommandListPtr CreateCommandList()
+    {
+        return CommandList::Create();
+    }
+    CommandListPtr CreateCommandList(ConstContextPtr context, ConstQueuePtr queue, const FlushPolicy& policy)
+    {
+        Error error;
+        auto res = CommandList::Create();
+
+        error = res->Init(context, queue, policy);
+        if (error != CL_SUCCESS)
+        {
+            return nullptr;
+        }
+
+        return res;
+    }
+    CommandList::~CommandList()
+    {
+#ifdef cl_khr_command_buffer
+        ReleaseNative();
+#endif
+    }
+    CommandListPtr CommandList::Create()
+    {
+        class MakeSharedEnabler : public CommandList
+        {
+        };
+
+        auto res = std::make_shared<MakeSharedEnabler>();
+        return res;
+    }
+    CommandListPtr CommandList::GetPtr()
+    {
+        return shared_from_this();
+    }
+    ConstCommandListPtr CommandList::GetPtr() const
+    {
+        return const_cast<CommandList*>(this)->GetPtr();
+    }
+    Error CommandList::Init(ConstContextPtr context, ConstQueuePtr queue, const FlushPolicy& policy)
+    {
+        if (initialized_)
+        {
+            return CL_SUCCESS;
+        }
+
+        if (!context)
+        {
+            logger::Error(header, "Command list not created: context pointer is null");
+
+            return CL_INVALID_CONTEXT;
+        }
+
+        context_ = context;
+        queue_ = queue ? queue : context->GetQueuePtr();
+        policy_ = policy;
+        initialized_ = true;
+
+        return CL_SUCCESS;
+    }
+    CommandId CommandList::RecordWrite(ConstBufferPtr buffer, std::size_t offset, std::size_t size, const void* ptr, const CommandIds& dependencies)
+    {
+        Command command;
+
+        if (!buffer || !ptr)
+        {
+            logger::Error(header, "Write not recorded: buffer or host pointer is null");
+
+            return invalidCommand;
+        }
+
+        command.type = Type::Write;
+        command.dependencies = dependencies;
+        command.dst = buffer;
+        command.dstOffset = offset;
+        command.size = size;
+        command.input = ptr;
+
+        return Record(std::move(command));
+    }
+    CommandId CommandList::RecordRead(ConstBufferPtr buffer, std::size_t offset, std::size_t size, void* ptr, const CommandIds& dependencies)
+    {
+        Command command;
+
+        if (!buffer || !ptr)
+        {
+            logger::Error(header, "Read not recorded: buffer or host pointer is null");
+
+            return invalidCommand;
+        }
+
+        command.type = Type::Read;
+        command.dependencies = dependencies;
+        command.src = buffer;
+        command.srcOffset = offset;
+        command.size = size;
+        command.output = ptr;
+
+        return Record(std::move(command));
+    }
+    CommandId CommandList::RecordCopy(ConstBufferPtr src, ConstBufferPtr dst, std::size_t srcOffset, std::size_t dstOffset, std::size_t size, const CommandIds& dependencies)
+    {
+        Command command;
+
+        if (!src || !dst)
+        {
+            logger::Error(header, "Copy not recorded: buffer pointer is null");
+
+            return invalidCommand;
+        }
+
+        command.type = Type::Copy;
+        command.dependencies = dependencies;
+        command.src = src;
+        command.dst = dst;
+        command.srcOffset = srcOffset;
+        command.dstOffset = dstOffset;
+        command.size = size;
+
+        return Record(std::move(command));
+    }
+    CommandId CommandList::RecordFill(ConstBufferPtr buffer, const void* pattern, std::size_t patternSize, std::size_t offset, std::size_t size, const CommandIds& dependencies)
+    {
+        Command command;
+
+        if (!buffer || !pattern || patternSize == 0)
+        {
+            logger::Error(header, "Fill not recorded: buffer or pattern is empty");
+
+            return invalidCommand;
+        }
+
+        // The pattern is copied, unlike the host pointers of reads and writes
+        command.type = Type::Fill;
+        command.dependencies = dependencies;
+        command.dst = buffer;
+        command.dstOffset = offset;
+        command.size = size;
+        command.pattern.assign(static_cast<const unsigned char*>(pattern), static_cast<const unsigned char*>(pattern) + patternSize);
+
+        return Record(std::move(command));
+    }
+    CommandId CommandList::RecordLaunch(KernelPtr kernel, const GlobalSize& globalSize, const GlobalOffset& globalOffset, const CommandIds& dependencies)
+    {
+        Command command;
+
+        if (!kernel)
+        {
+            logger::Error(header, "Launch not recorded: kernel pointer is null");
+
+            return invalidCommand;
+        }
+
+        auto dim = kernel->GetDim();
+        if (dim < 1 || dim > 3 || globalSize.size() != dim || (!globalOffset.empty() && globalOffset.size() != dim))
+        {
+            logger::Error(header, utils::string::Format("Launch of kernel {} not recorded: invalid dimension {:d}", kernel->GetName(), globalSize.size()));
+
+            return invalidCommand;
+        }
+
+        auto numberArgs = kernel->GetInfo().numberArgs;
+        {
+            std::lock_guard<std::mutex> lock(kernel->argsMutex_);
+
+            if (kernel->args_.size() < numberArgs ||
+                !std::all_of(kernel->args_.begin(), kernel->args_.begin() + numberArgs, [](const Kernel::BoundArg& arg) { return arg.bound; }))
+            {
+                logger::Error(header, utils::string::Format("Launch of kernel {} not recorded: arguments must be bound with SetArgs", kernel->GetName()));
+
+                return invalidCommand;
+            }
+
+            command.args.assign(kernel->args_.begin(), kernel->args_.begin() + numberArgs);
+        }
+
+        command.type = Type::Launch;
+        command.dependencies = dependencies;
+        command.kernel = kernel;
+        command.dim = dim;
+        command.hasOffset = !globalOffset.empty();
+
+        const auto& localSize = kernel->GetLocalSize();
+        for (Index i = 0; i < dim; ++i)
+        {
+            command.local[i] = localSize[i];
+            command.global[i] = ((globalSize[i] + localSize[i] - 1) / localSize[i]) * localSize[i];
+            command.offset[i] = command.hasOffset ? globalOffset[i] : 0;
+        }
+
+        return Record(std::move(command));
+    }
+    CommandId CommandList::Record(Command&& command)
+    {
+        if (!initialized_ || finalized_)
+        {
+            logger::Error(header, "Command not recorded: command list is not initialized or already finalized");
+
+            return invalidCommand;
+        }
+
+        for (const auto& it : command.dependencies)
+        {
+            if (it >= commands_.size())
+            {
+                logger::Error(header, utils::string::Format("Command not recorded: dependency {:d} was not recorded before", it));
+
+                return invalidCommand;
+            }
+        }
+
+        commands_.push_back(std::move(command));
+
+        return commands_.size() - 1;
+    }
+    Error CommandList::Finalize()
+    {
+        if (!initialized_)
+        {
+            return CL_INVALID_OPERATION;
+        }
+
+        if (finalized_)
+        {
+            return CL_SUCCESS;
+        }
+
+        events_.assign(commands_.size(), nullptr);
+
+#ifdef cl_khr_command_buffer
+        // Lists the extension cannot hold fall back to the recorded replay
+        FinalizeNative();
+#endif
+
+        finalized_ = true;
+
+        return CL_SUCCESS;
+    }
+    Error CommandList::Replay(const Events& waitList)
+    {
+        Error error = CL_SUCCESS;
+
+        if (!finalized_ && (error = Finalize()) != CL_SUCCESS)
+        {
+            return error;
+        }
+
+#ifdef cl_khr_command_buffer
+        if (commandBuffer_)
+        {
+            // A command buffer without simultaneous use cannot be enqueued while the previous replay is pending
+            if (replayEvent_)
+            {
+                clWaitForEvents(1, &replayEvent_);
+                clReleaseEvent(replayEvent_);
+                replayEvent_ = nullptr;
+            }
+
+            error = enqueueCommandBuffer_(0, NULL, commandBuffer_, static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(),
+                simultaneous_ ? NULL : &replayEvent_);
+            if (error != CL_SUCCESS)
+            {
+                logger::Error(header, utils::string::Format("Command buffer could not be enqueued: {}", GetErrorMessage(error)));
+
+                return error;
+            }
+
+            return policy_.finish ? queue_->Finish() : queue_->Flush();
+        }
+#endif
+
+        // In order queues already serialize the commands, only out of order queues need events for the dependencies
+        bool ordered = !queue_->IsOutOfOrder();
+        Index i = 0;
+
+        for (; i < commands_.size(); ++i)
+        {
+            const auto& command = commands_[i];
+
+            dependencies_.clear();
+            if (ordered ? i == 0 : command.dependencies.empty())
+            {
+                dependencies_.insert(dependencies_.end(), waitList.begin(), waitList.end());
+            }
+            else if (!ordered)
+            {
+                for (const auto& it : command.dependencies)
+                {
+                    dependencies_.push_back(events_[it]);
+                }
+            }
+
+            if (command.type == Type::Launch)
+            {
+                BindArgs(command, command.kernel);
+            }
+
+            error = Enqueue(command, static_cast<cl_uint>(dependencies_.size()), dependencies_.empty() ? NULL : dependencies_.data(), ordered ? NULL : &events_[i]);
+            if (error != CL_SUCCESS)
+            {
+                logger::Error(header, utils::string::Format("Command {:d} could not be replayed: {}", i, GetErrorMessage(error)));
+
+                break;
+            }
+
+            if (policy_.commands != 0 && (i + 1) % policy_.commands == 0)
+            {
+                queue_->Flush();
+            }
+        }
+
+        // The queue keeps its own references, so the events can be released before they complete
+        for (auto& it : events_)
+        {
+            if (it)
+            {
+                clReleaseEvent(it);
+                it = nullptr;
+            }
+        }
+
+        if (error != CL_SUCCESS)
+        {
+            return error;
+        }
+
+        return policy_.finish ? queue_->Finish() : queue_->Flush();
+    }
+    ConstQueuePtr CommandList::GetQueuePtr() const
+    {
+        return queue_;
+    }
+    const FlushPolicy& CommandList::GetPolicy() const
+    {
+        return policy_;
+    }
+    std::size_t CommandList::GetSize() const
+    {
+        return commands_.size();
+    }
+    bool CommandList::IsNative() const
+    {
+#ifdef cl_khr_command_buffer
+        return commandBuffer_ != nullptr;
+#else
+        return false;
+#endif
+    }
+    Error CommandList::Enqueue(const Command& command, cl_uint numberEvents, const cl_event* waitList, cl_event* event) const
+    {
+        auto queue = queue_->Get();
+
+        switch (command.type)
+        {
+        case Type::Write:
+            return clEnqueueWriteBuffer(queue, command.dst->Get(), CL_FALSE, command.dstOffset, command.size, command.input, numberEvents, waitList, event);
+        case Type::Read:
+            return clEnqueueReadBuffer(queue, command.src->Get(), CL_FALSE, command.srcOffset, command.size, command.output, numberEvents, waitList, event);
+        case Type::Copy:
+            return clEnqueueCopyBuffer(queue, command.src->Get(), command.dst->Get(), command.srcOffset, command.dstOffset, command.size, numberEvents, waitList, event);
+        case Type::Fill:
+            return clEnqueueFillBuffer(queue, command.dst->Get(), command.pattern.data(), command.pattern.size(), command.dstOffset, command.size, numberEvents, waitList, event);
+        case Type::Launch:
+            return clEnqueueNDRangeKernel(queue, command.kernel->GetKernel(), command.dim, command.hasOffset ? command.offset.data() : NULL,
+                command.global.data(), command.local.data(), numberEvents, waitList, event);
+        }
+
+        return CL_INVALID_OPERATION;
+    }
+    void CommandList::BindArgs(const Command& command, const KernelPtr& kernel) const
+    {
+        // Arguments shared by consecutive launches of the same kernel are elided by the kernel cache
+        for (ArgNumber i = 0; i < command.args.size(); ++i)
+        {
+            const auto& arg = command.args[i];
+            kernel->BindArg(i, arg.value.size(), arg.value.data(), arg.local);
+        }
+    }
+#ifdef cl_khr_command_buffer
+    Error CommandList::FinalizeNative()
+    {
+        Error error;
+        const auto& deviceInfo = context_->GetDeviceInfo();
+
+        if (commands_.empty() || String(deviceInfo.extensions.data()).find("cl_khr_command_buffer") == String::npos ||
+            std::any_of(commands_.begin(), commands_.end(), [](const Command& command) { return command.type == Type::Write || command.type == Type::Read; }))
+        {
+            return CL_INVALID_OPERATION;
+        }
+
+        auto platform = context_->GetPlatform();
+        auto createCommandBuffer = reinterpret_cast<clCreateCommandBufferKHR_fn>(clGetExtensionFunctionAddressForPlatform(platform, "clCreateCommandBufferKHR"));
+        auto commandCopyBuffer = reinterpret_cast<clCommandCopyBufferKHR_fn>(clGetExtensionFunctionAddressForPlatform(platform, "clCommandCopyBufferKHR"));
+        auto commandFillBuffer = reinterpret_cast<clCommandFillBufferKHR_fn>(clGetExtensionFunctionAddressForPlatform(platform, "clCommandFillBufferKHR"));
+        auto commandNDRangeKernel = reinterpret_cast<clCommandNDRangeKernelKHR_fn>(clGetExtensionFunctionAddressForPlatform(platform, "clCommandNDRangeKernelKHR"));
+        auto finalizeCommandBuffer = reinterpret_cast<clFinalizeCommandBufferKHR_fn>(clGetExtensionFunctionAddressForPlatform(platform, "clFinalizeCommandBufferKHR"));
+        enqueueCommandBuffer_ = reinterpret_cast<clEnqueueCommandBufferKHR_fn>(clGetExtensionFunctionAddressForPlatform(platform, "clEnqueueCommandBufferKHR"));
+        releaseCommandBuffer_ = reinterpret_cast<clReleaseCommandBufferKHR_fn>(clGetExtensionFunctionAddressForPlatform(platform, "clReleaseCommandBufferKHR"));
+
+        if (!createCommandBuffer || !commandCopyBuffer || !commandFillBuffer || !commandNDRangeKernel || !finalizeCommandBuffer || !enqueueCommandBuffer_ ||
+            !releaseCommandBuffer_)
+        {
+            return CL_INVALID_OPERATION;
+        }
+
+        cl_command_buffer_properties_khr properties[] = { 0, 0, 0 };
+#ifdef CL_COMMAND_BUFFER_SIMULTANEOUS_USE_KHR
+        cl_device_command_buffer_capabilities_khr capabilities = 0;
+        clGetDeviceInfo(context_->GetDevice(), CL_DEVICE_COMMAND_BUFFER_CAPABILITIES_KHR, sizeof(capabilities), &capabilities, NULL);
+
+        simultaneous_ = (capabilities & CL_COMMAND_BUFFER_CAPABILITY_SIMULTANEOUS_USE_KHR) != 0;
+        if (simultaneous_)
+        {
+            properties[0] = CL_COMMAND_BUFFER_FLAGS_KHR;
+            properties[1] = CL_COMMAND_BUFFER_SIMULTANEOUS_USE_KHR;
+        }
+#endif
+
+        auto queue = queue_->Get();
+        commandBuffer_ = createCommandBuffer(1, &queue, properties, &error);
+        if (error != CL_SUCCESS)
+        {
+            commandBuffer_ = nullptr;
+
+            return error;
+        }
+
+        // Each command waits on the previous one, matching the order of the recording
+        cl_sync_point_khr previous = 0;
+        for (Index i = 0; i < commands_.size(); ++i)
+        {
+            const auto& command = commands_[i];
+            cl_uint numberSyncPoints = i > 0 ? 1 : 0;
+            const cl_sync_point_khr* syncPoints = i > 0 ? &previous : NULL;
+            cl_sync_point_khr current;
+
+            switch (command.type)
+            {
+            case Type::Copy:
+                error = commandCopyBuffer(commandBuffer_, NULL, CLUB_COMMAND_PROPERTIES command.src->Get(), command.dst->Get(), command.srcOffset, command.dstOffset,
+                    command.size, numberSyncPoints, syncPoints, &current, NULL);
+                break;
+            case Type::Fill:
+                error = commandFillBuffer(commandBuffer_, NULL, CLUB_COMMAND_PROPERTIES command.dst->Get(), command.pattern.data(), command.pattern.size(),
+                    command.dstOffset, command.size, numberSyncPoints, syncPoints, &current, NULL);
+                break;
+            case Type::Launch:
+            {
+                // The arguments are captured when the launch is recorded, on an instance the caller never binds
+                auto instance = command.kernel->CreateInstance();
+                if (!instance)
+                {
+                    error = CL_INVALID_KERNEL;
+                    break;
+                }
+
+                BindArgs(command, instance);
+                instances_.push_back(instance);
+
+                error = commandNDRangeKernel(commandBuffer_, NULL, NULL, instance->GetKernel(), command.dim, command.hasOffset ? command.offset.data() : NULL,
+                    command.global.data(), command.local.data(), numberSyncPoints, syncPoints, &current, NULL);
+                break;
+            }
+            default:
+                error = CL_INVALID_OPERATION;
+                break;
+            }
+
+            if (error != CL_SUCCESS)
+            {
+                ReleaseNative();
+
+                return error;
+            }
+
+            previous = current;
+        }
+
+        error = finalizeCommandBuffer(commandBuffer_);
+        if (error != CL_SUCCESS)
+        {
+            ReleaseNative();
+
+            return error;
+        }
+
+        logger::Info(header, utils::string::Format("Command list of {:d} commands recorded into a command buffer", commands_.size()));
+
+        return CL_SUCCESS;
+    }
+    void CommandList::ReleaseNative()
+    {
+        if (commandBuffer_)
+        {
+            releaseCommandBuffer_(commandBuffer_);
+            commandBuffer_ = nullptr;
+        }
+
+        if (replayEvent_)
+        {
+            clReleaseEvent(replayEvent_);
+            replayEvent_ = nullptr;
+        }
+
+        instances_.clear();
+    }
+#endif
+} // namespace club
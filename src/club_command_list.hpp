@@ -0,0 +1,117 @@
+#ifndef CLUB_COMMAND_LIST_HPP_
+#define CLUB_COMMAND_LIST_HPP_
+
+#include "club_buffer.hpp"
+#include "club_kernel.hpp"
+#include "club_queue.hpp"
+
+#ifdef __APPLE__
+#include <OpenCL/cl_ext.h>
+#else
+#include <CL/cl_ext.h>
+#endif
+
+namespace club
+{
+    CommandListPtr CreateCommandList();
+    CommandListPtr CreateCommandList(ConstContextPtr context, ConstQueuePtr queue = nullptr, const FlushPolicy& policy = FlushPolicy());
+
+    // Records a fixed sequence of club operations once and replays it without events, logging or info queries
+    class CommandList : public std::enable_shared_from_this<CommandList>
+    {
+    public:
+        virtual ~CommandList();
+
+        static CommandListPtr Create();
+        CommandListPtr GetPtr();
+        ConstCommandListPtr GetPtr() const;
+
+        Error Init(ConstContextPtr context, ConstQueuePtr queue, const FlushPolicy& policy);
+
+        // Host pointers are read or written at replay time, not while recording
+        CommandId RecordWrite(ConstBufferPtr buffer, std::size_t offset, std::size_t size, const void* ptr, const CommandIds& dependencies = {});
+        CommandId RecordRead(ConstBufferPtr buffer, std::size_t offset, std::size_t size, void* ptr, const CommandIds& dependencies = {});
+        CommandId RecordCopy(ConstBufferPtr src, ConstBufferPtr dst, std::size_t srcOffset, std::size_t dstOffset, std::size_t size, const CommandIds& dependencies = {});
+        CommandId RecordFill(ConstBufferPtr buffer, const void* pattern, std::size_t patternSize, std::size_t offset, std::size_t size, const CommandIds& dependencies = {});
+        // Snapshots the arguments bound through Kernel::SetArgs and the local size
+        CommandId RecordLaunch(KernelPtr kernel, const GlobalSize& globalSize, const GlobalOffset& globalOffset = {}, const CommandIds& dependencies = {});
+
+        Error Finalize();
+        Error Replay(const Events& waitList = {});
+
+        ConstQueuePtr GetQueuePtr() const;
+        const FlushPolicy& GetPolicy() const;
+        std::size_t GetSize() const;
+        bool IsNative() const;
+
+    protected:
+        CommandList() = default;
+
+        enum class Type
+        {
+            Write,
+            Read,
+            Copy,
+            Fill,
+            Launch
+        };
+
+        struct Command
+        {
+            Type type;
+            CommandIds dependencies;
+
+            ConstBufferPtr src;
+            ConstBufferPtr dst;
+            std::size_t srcOffset{ 0 };
+            std::size_t dstOffset{ 0 };
+            std::size_t size{ 0 };
+            const void* input{ nullptr };
+            void* output{ nullptr };
+            std::vector<unsigned char> pattern;
+
+            KernelPtr kernel;
+            std::vector<Kernel::BoundArg> args;
+            Dimension dim{ 0 };
+            std::array<std::size_t, 3> global{ 0, 0, 0 };
+            std::array<std::size_t, 3> local{ 1, 1, 1 };
+            std::array<std::size_t, 3> offset{ 0, 0, 0 };
+            bool hasOffset{ false };
+        };
+
+        CommandId Record(Command&& command);
+        Error Enqueue(const Command& command, cl_uint numberEvents, const cl_event* waitList, cl_event* event) const;
+        void BindArgs(const Command& command, const KernelPtr& kernel) const;
+
+#ifdef cl_khr_command_buffer
+        Error FinalizeNative();
+        void ReleaseNative();
+#endif
+
+        bool initialized_{ false };
+        bool finalized_{ false };
+
+        ConstContextPtr context_{ nullptr };
+        ConstQueuePtr queue_{ nullptr };
+        FlushPolicy policy_;
+
+        std::vector<Command> commands_;
+        std::vector<cl_event> events_;
+        Events dependencies_;
+
+#ifdef cl_khr_command_buffer
+        // Lists of copies, fills and launches are recorded once into a command buffer when the device supports it,
+        // lists with host reads or writes always replay command by command
+        cl_command_buffer_khr commandBuffer_{ nullptr };
+        clEnqueueCommandBufferKHR_fn enqueueCommandBuffer_{ nullptr };
+        clReleaseCommandBufferKHR_fn releaseCommandBuffer_{ nullptr };
+        // Each launch is recorded from its own kernel instance, so the caller's kernel keeps its arguments
+        std::vector<KernelPtr> instances_;
+        // Without simultaneous use a replay waits for the previous one to complete
+        bool simultaneous_{ false };
+        cl_event replayEvent_{ nullptr };
+#endif
+    };
+} // namespace club
+
+#endif /* CLUB_COMMAND_LIST_HPP_ */
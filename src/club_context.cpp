@@ -6,12 +6,12 @@ namespace club
     {
         return Context::Create();
     }
-    ContextPtr CreateContext(ConstPlatformPtr platform, const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber)
+    ContextPtr CreateContext(ConstPlatformPtr platform, const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber, cl_command_queue_properties properties)
     {
         Error error;
         auto res = Context::Create();
 
-        error = res->Init(platform, platformNumber, deviceNumber);
+        error = res->Init(platform, platformNumber, deviceNumber, properties);
         if (error != CL_SUCCESS)
         {
             return nullptr;
@@ -21,7 +21,7 @@ namespace club
     }
     Context::~Context()
     {
-        clReleaseCommandQueue(queue_);
+        queues_.clear();
         clReleaseContext(context_);
     }
     ContextPtr Context::Create()
@@ -41,7 +41,7 @@ namespace club
     {
         return const_cast<Context*>(this)->GetPtr();
     }
-    Error Context::Init(ConstPlatformPtr platform, const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber)
+    Error Context::Init(ConstPlatformPtr platform, const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber, cl_command_queue_properties properties)
     {
         Error error;
         Devices dev;
@@ -88,8 +88,9 @@ namespace club
         }
 
         contextInfo_ = GetContextInfo(context_);
-        queue_ = clCreateCommandQueueWithProperties(context_, platform_->GetDevice(platformNumber, deviceNumber),
-            queueProps_, &error);
+
+        QueuePtr queue;
+        error = InitQueue(properties, queue);
         if (error != CL_SUCCESS)
         {
             logger::Error(header, utils::string::Format("Queue {:d}{:d} not created: {}", platformNumber, deviceNumber, messages.at(error)));
@@ -99,7 +100,6 @@ namespace club
             return error;
         }
 
-        queueInfo_ = GetQueueInfo(queue_);
         initialized_ = true;
 
         return CL_SUCCESS;
@@ -112,13 +112,59 @@ namespace club
     {
         return deviceNumber_;
     }
+    QueuePtr Context::AddQueue(cl_command_queue_properties properties)
+    {
+        QueuePtr res;
+
+        InitQueue(properties, res);
+
+        return res;
+    }
+    Error Context::InitQueue(cl_command_queue_properties properties, QueuePtr& queue)
+    {
+        Error error;
+        auto res = Queue::Create();
+
+        error = res->Init(context_, GetDevice(), properties);
+        if (error != CL_SUCCESS)
+        {
+            return error;
+        }
+
+        std::lock_guard<std::mutex> lock(queuesMutex_);
+        queues_.push_back(res);
+        queue = res;
+
+        return CL_SUCCESS;
+    }
+    NumberQueues Context::GetNumberQueues() const
+    {
+        std::lock_guard<std::mutex> lock(queuesMutex_);
+
+        return static_cast<NumberQueues>(queues_.size());
+    }
+    ConstQueuePtr Context::GetQueuePtr(const Index& index) const
+    {
+        std::lock_guard<std::mutex> lock(queuesMutex_);
+
+        if (index >= queues_.size())
+        {
+            logger::Error(header, utils::string::Format("Queue {:d} not found: context has {:d} queues", index, queues_.size()));
+
+            return nullptr;
+        }
+
+        return queues_[index];
+    }
     const cl_context& Context::Get() const
     {
         return context_;
     }
     const cl_command_queue& Context::GetQueue() const
     {
-        return queue_;
+        std::lock_guard<std::mutex> lock(queuesMutex_);
+
+        return queues_[0]->Get();
     }
     const cl_device_id& Context::GetDevice() const
     {
@@ -132,14 +178,24 @@ namespace club
     {
         return contextInfo_;
     }
+    const DeviceInfo& Context::GetDeviceInfo() const
+    {
+        return platform_->GetDeviceInfo(platformNumber_, deviceNumber_);
+    }
     const QueueInfo& Context::GetQueueInfo() const
     {
-        return queueInfo_;
+        std::lock_guard<std::mutex> lock(queuesMutex_);
+
+        return queues_[0]->GetInfo();
     }
     ConstPlatformPtr Context::GetPlatformPtr() const
     {
         return platform_;
     }
+    const Counters& Context::GetCounters() const
+    {
+        return counters_;
+    }
     ContextInfo Context::GetContextInfo(cl_context context) const
     {
         ContextInfo res;
@@ -151,16 +207,6 @@ namespace club
 
         return res;
     }
-    QueueInfo Context::GetQueueInfo(cl_command_queue queue) const
-    {
-        QueueInfo res;
-
-        res.context = GetQueueInfo<cl_context>(queue, CL_QUEUE_CONTEXT);
-        res.device = GetQueueInfo<cl_device_id>(queue, CL_QUEUE_DEVICE);
-        res.properties = GetQueueInfo<cl_command_queue_properties>(queue, CL_QUEUE_PROPERTIES);
-
-        return res;
-    }
 
     template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type Context::GetContextInfo(cl_context context, cl_context_info info) const
     {
@@ -183,26 +229,4 @@ namespace club
 
         return res;
     }
-
-    template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type Context::GetQueueInfo(cl_command_queue queue, cl_command_queue_info info) const
-    {
-        std::size_t size;
-        T res;
-
-        clGetCommandQueueInfo(queue, info, 0, NULL, &size);
-        clGetCommandQueueInfo(queue, info, size, &res, 0);
-
-        return res;
-    }
-    template <typename T> typename std::enable_if<is_vector<T>::value, T>::type Context::GetQueueInfo(cl_command_queue queue, cl_command_queue_info info) const
-    {
-        std::size_t size;
-        T res;
-
-        clGetCommandQueueInfo(queue, info, 0, NULL, &size);
-        res.resize(size);
-        clGetCommandQueueInfo(queue, info, size, &res[0], 0);
-
-        return res;
-    }
 } // namespace club
\ No newline at end of file
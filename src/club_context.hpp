@@ -1,12 +1,16 @@
 #ifndef CLUB_CONTEXT_HPP_
 #define CLUB_CONTEXT_HPP_
 
+#include "club_counters.hpp"
 #include "club_platform.hpp"
+#include "club_queue.hpp"
+
+#include <mutex>
 
 namespace club
 {
     ContextPtr CreateContext();
-    ContextPtr CreateContext(ConstPlatformPtr platform, const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber);
+    ContextPtr CreateContext(ConstPlatformPtr platform, const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber, cl_command_queue_properties properties = 0);
 
     class Context : public std::enable_shared_from_this<Context>
     {
@@ -17,33 +21,37 @@ namespace club
         ContextPtr GetPtr();
         ConstContextPtr GetPtr() const;
 
-        Error Init(ConstPlatformPtr platform, const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber);
+        Error Init(ConstPlatformPtr platform, const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber, cl_command_queue_properties properties = 0);
 
         PlatformNumber GetPlatformNumber() const;
         DeviceNumber GetDeviceNumber() const;
 
+        QueuePtr AddQueue(cl_command_queue_properties properties = 0);
+
+        NumberQueues GetNumberQueues() const;
+        ConstQueuePtr GetQueuePtr(const Index& index = 0) const;
+
         const cl_context& Get() const;
         const cl_command_queue& GetQueue() const;
         const cl_device_id& GetDevice() const;
         const cl_platform_id& GetPlatform() const;
 
         const ContextInfo& GetInfo() const;
+        const DeviceInfo& GetDeviceInfo() const;
         const QueueInfo& GetQueueInfo() const;
 
         ConstPlatformPtr GetPlatformPtr() const;
+        const Counters& GetCounters() const;
 
     protected:
         Context() = default;
 
         ContextInfo GetContextInfo(cl_context context) const;
-        QueueInfo GetQueueInfo(cl_command_queue queue) const;
+        Error InitQueue(cl_command_queue_properties properties, QueuePtr& queue);
 
         template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type GetContextInfo(cl_context context, cl_context_info info) const;
         template <typename T> typename std::enable_if<is_vector<T>::value, T>::type GetContextInfo(cl_context context,  cl_context_info info) const;
 
-        template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type GetQueueInfo(cl_command_queue queue, cl_command_queue_info info) const;
-        template <typename T> typename std::enable_if<is_vector<T>::value, T>::type GetQueueInfo(cl_command_queue queue, cl_command_queue_info info) const;
-
         bool initialized_{ false };
 
         ConstPlatformPtr platform_{ nullptr };
@@ -52,13 +60,15 @@ namespace club
         DeviceNumber deviceNumber_{ 0 };
 
         cl_context context_;
-        cl_command_queue queue_;
+
+        // Queues may be added while other threads look them up
+        mutable std::mutex queuesMutex_;
+        std::vector<QueuePtr> queues_;
 
         ContextInfo contextInfo_;
-        QueueInfo queueInfo_;
+        Counters counters_;
 
         cl_context_properties contextProps_[3] = { CL_CONTEXT_PLATFORM, 0, 0 };
-        cl_queue_properties queueProps_[1] = { 0 };
     };
 } // namespace club
 
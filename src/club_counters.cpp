@@ -0,0 +1,122 @@
+#include "club_counters.hpp"
+#include "club_trace.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace club
+{
+    namespace
+    {
+        const char* counterNames[numberCounters] = {
+            "enqueue_read", "enqueue_write", "enqueue_copy", "enqueue_fill", "enqueue_map", "enqueue_kernel",
+            "bytes_read", "bytes_written", "bytes_copied",
+            "buffers_created", "programs_created", "programs_cached", "kernels_created", "build_time_ns",
+            "set_arg_calls", "set_arg_skipped" };
+
+        const char* latencyNames[numberLatencies] = { "read", "write", "copy", "fill", "map", "kernel", "build" };
+    } // namespace
+
+    const char* GetName(Counter counter)
+    {
+        return counterNames[static_cast<std::size_t>(counter)];
+    }
+    const char* GetName(Latency latency)
+    {
+        return latencyNames[static_cast<std::size_t>(latency)];
+    }
+    String ToJson(const CountersSnapshot& snapshot)
+    {
+        String res = "{\"counters\":{";
+
+        for (std::size_t i = 0; i < numberCounters; ++i)
+        {
+            res += (i > 0 ? ",\"" : "\"") + String(counterNames[i]) + "\":" + std::to_string(snapshot.counters[i]);
+        }
+
+        res += "},\"latencies\":{";
+
+        for (std::size_t i = 0; i < numberLatencies; ++i)
+        {
+            res += (i > 0 ? ",\"" : "\"") + String(latencyNames[i]) + "\":[";
+
+            for (std::size_t j = 0; j < numberLatencyBuckets; ++j)
+            {
+                res += (j > 0 ? "," : "") + std::to_string(snapshot.latencies[i][j]);
+            }
+
+            res += "]";
+        }
+
+        res += "}}";
+
+        return res;
+    }
+#if CLUB_INSTRUMENTATION
+    void Counters::Record(Latency latency, std::uint64_t nanoseconds) const
+    {
+        auto bucket = std::min<std::size_t>(std::bit_width(nanoseconds), numberLatencyBuckets - 1);
+
+        latencies_[static_cast<std::size_t>(latency)][bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+    Probe::~Probe()
+    {
+        auto end = std::chrono::steady_clock::now();
+
+        counters_.Record(latency_, std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin_).count());
+
+        if (IsTracing())
+        {
+            TraceRecord record{};
+
+            record.operation = latency_;
+            if (name_)
+            {
+                std::strncpy(record.name, name_, traceNameSize - 1);
+            }
+            record.bytes = bytes_;
+            record.queue = queue_;
+            record.hostBegin = std::chrono::duration_cast<std::chrono::nanoseconds>(begin_.time_since_epoch()).count();
+            record.hostEnd = std::chrono::duration_cast<std::chrono::nanoseconds>(end.time_since_epoch()).count();
+
+            TraceCommand(record, event_);
+        }
+    }
+    CountersSnapshot Counters::GetSnapshot() const
+    {
+        CountersSnapshot res{};
+
+        // Counters are read one by one, a snapshot taken under load is not atomic as a whole
+        for (std::size_t i = 0; i < numberCounters; ++i)
+        {
+            res.counters[i] = counters_[i].load(std::memory_order_relaxed);
+        }
+
+        for (std::size_t i = 0; i < numberLatencies; ++i)
+        {
+            for (std::size_t j = 0; j < numberLatencyBuckets; ++j)
+            {
+                res.latencies[i][j] = latencies_[i][j].load(std::memory_order_relaxed);
+            }
+        }
+
+        return res;
+    }
+    void Counters::Reset() const
+    {
+        for (auto& it : counters_)
+        {
+            it.store(0, std::memory_order_relaxed);
+        }
+
+        for (auto& histogram : latencies_)
+        {
+            for (auto& it : histogram)
+            {
+                it.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+#endif
+} // namespace club
@@ -0,0 +1,134 @@
+#ifndef CLUB_COUNTERS_HPP_
+#define CLUB_COUNTERS_HPP_
+
+#include "club_types.hpp"
+
+#include <atomic>
+#include <chrono>
+
+// Set for the whole workspace by premake5.lua, code built outside it must use the value the library was built with
+#ifndef CLUB_INSTRUMENTATION
+#define CLUB_INSTRUMENTATION 1
+#endif
+
+namespace club
+{
+    // Building with CLUB_INSTRUMENTATION=0 compiles the counters, probes and their storage away
+    constexpr bool instrumentation = CLUB_INSTRUMENTATION != 0;
+
+    enum class Counter
+    {
+        EnqueueRead,
+        EnqueueWrite,
+        EnqueueCopy,
+        EnqueueFill,
+        EnqueueMap,
+        EnqueueKernel,
+        BytesRead,
+        BytesWritten,
+        BytesCopied,
+        BuffersCreated,
+        ProgramsCreated,
+        ProgramsCached,
+        KernelsCreated,
+        BuildTime,
+        SetArgCalls,
+        SetArgSkipped,
+        Count
+    };
+    enum class Latency
+    {
+        Read,
+        Write,
+        Copy,
+        Fill,
+        Map,
+        Kernel,
+        Build,
+        Count
+    };
+
+    const std::size_t numberCounters = static_cast<std::size_t>(Counter::Count);
+    const std::size_t numberLatencies = static_cast<std::size_t>(Latency::Count);
+    // Bucket i holds host latencies below 2^i nanoseconds, the last one everything slower
+    const std::size_t numberLatencyBuckets = 32;
+
+    using LatencyHistogram = std::array<std::uint64_t, numberLatencyBuckets>;
+
+    struct CountersSnapshot
+    {
+        std::array<std::uint64_t, numberCounters> counters;
+        std::array<LatencyHistogram, numberLatencies> latencies;
+    };
+
+    const char* GetName(Counter counter);
+    const char* GetName(Latency latency);
+    String ToJson(const CountersSnapshot& snapshot);
+
+    class Counters
+    {
+    public:
+#if CLUB_INSTRUMENTATION
+        void Add(Counter counter, std::uint64_t value = 1) const
+        {
+            counters_[static_cast<std::size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+        }
+        void Record(Latency latency, std::uint64_t nanoseconds) const;
+
+        CountersSnapshot GetSnapshot() const;
+        void Reset() const;
+
+    protected:
+        mutable std::array<std::atomic<std::uint64_t>, numberCounters> counters_{};
+        mutable std::array<std::array<std::atomic<std::uint64_t>, numberLatencyBuckets>, numberLatencies> latencies_{};
+#else
+        void Add(Counter, std::uint64_t = 1) const {}
+        void Record(Latency, std::uint64_t) const {}
+
+        CountersSnapshot GetSnapshot() const { return {}; }
+        void Reset() const {}
+#endif
+    };
+
+    // Times the enclosing scope into a latency histogram and, while tracing, into the trace of the calling thread
+    class Probe
+    {
+    public:
+#if CLUB_INSTRUMENTATION
+        Probe(const Counters& counters, Latency latency, const char* name = nullptr) : counters_(counters), latency_(latency), name_(name)
+        {
+            begin_ = std::chrono::steady_clock::now();
+        }
+        ~Probe();
+#else
+        Probe(const Counters&, Latency, const char* = nullptr) {}
+#endif
+
+        Probe(const Probe&) = delete;
+        Probe& operator=(const Probe&) = delete;
+
+        // Attaches the enqueued command so the trace can place it on the track of its queue
+#if CLUB_INSTRUMENTATION
+        void SetCommand(cl_command_queue queue, cl_event event, std::uint64_t bytes)
+        {
+            queue_ = queue;
+            event_ = event;
+            bytes_ = bytes;
+        }
+
+    protected:
+        const Counters& counters_;
+        Latency latency_;
+        const char* name_;
+        std::chrono::steady_clock::time_point begin_;
+
+        cl_command_queue queue_{ nullptr };
+        cl_event event_{ nullptr };
+        std::uint64_t bytes_{ 0 };
+#else
+        void SetCommand(cl_command_queue, cl_event, std::uint64_t) {}
+#endif
+    };
+} // namespace club
+
+#endif /* CLUB_COUNTERS_HPP_ */
@@ -0,0 +1,240 @@
+#include "club_dispatcher.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace club
+{
+    namespace
+    {
+        thread_local const Dispatcher* currentDispatcher = nullptr;
+    } // namespace
+
+    DispatcherPtr CreateDispatcher()
+    {
+        return Dispatcher::Create();
+    }
+    DispatcherPtr CreateDispatcher(std::size_t numberThreads, std::size_t capacity)
+    {
+        Error error;
+        auto res = Dispatcher::Create();
+
+        error = res->Init(numberThreads, capacity);
+        if (error != CL_SUCCESS)
+        {
+            return nullptr;
+        }
+
+        return res;
+    }
+    DispatcherPtr GetDispatcher()
+    {
+        // Intentionally leaked: a static destructor would wait at exit for callbacks the driver may never deliver,
+        // the workers are left blocked and end with the process
+        static const DispatcherPtr* dispatcher = new DispatcherPtr(CreateDispatcher(std::max(std::thread::hardware_concurrency() / 2, 1u)));
+
+        return *dispatcher;
+    }
+    Dispatcher::~Dispatcher()
+    {
+        auto self = std::this_thread::get_id();
+
+        if (currentDispatcher != this)
+        {
+            // Callbacks still held by the driver post here, the dispatcher stays alive until they are all dispatched
+            std::unique_lock<std::mutex> lock(mutex_);
+            released_.wait(lock, [this]() { return outstanding_ == 0; });
+            stop_ = true;
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+
+        tasksReady_.notify_all();
+        released_.notify_all();
+
+        for (auto& it : threads_)
+        {
+            if (it.joinable() && it.get_id() != self)
+            {
+                it.join();
+            }
+        }
+
+        if (currentDispatcher != this)
+        {
+            return;
+        }
+
+        // Destroyed from one of its own tasks: the remaining work runs on this thread, which cannot join itself
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (outstanding_ > 0 || !tasks_.empty())
+        {
+            tasksReady_.wait(lock, [this]() { return outstanding_ == 0 || !tasks_.empty(); });
+
+            if (!tasks_.empty())
+            {
+                auto task = std::move(tasks_.front());
+                tasks_.pop_front();
+
+                lock.unlock();
+                Execute(task);
+                lock.lock();
+            }
+        }
+
+        for (auto& it : threads_)
+        {
+            if (it.joinable())
+            {
+                it.detach();
+            }
+        }
+
+        currentDispatcher = nullptr;
+    }
+    DispatcherPtr Dispatcher::Create()
+    {
+        class MakeSharedEnabler : public Dispatcher
+        {
+        };
+
+        auto res = std::make_shared<MakeSharedEnabler>();
+        return res;
+    }
+    DispatcherPtr Dispatcher::GetPtr()
+    {
+        return shared_from_this();
+    }
+    ConstDispatcherPtr Dispatcher::GetPtr() const
+    {
+        return const_cast<Dispatcher*>(this)->GetPtr();
+    }
+    Error Dispatcher::Init(std::size_t numberThreads, std::size_t capacity)
+    {
+        if (initialized_)
+        {
+            return CL_SUCCESS;
+        }
+
+        if (numberThreads == 0 || capacity == 0)
+        {
+            logger::Error(header, "Dispatcher not created: it needs at least one thread and a capacity");
+
+            return CL_INVALID_VALUE;
+        }
+
+        capacity_ = capacity;
+
+        for (std::size_t i = 0; i < numberThreads; ++i)
+        {
+            threads_.emplace_back(&Dispatcher::Run, this);
+        }
+
+        initialized_ = true;
+
+        return CL_SUCCESS;
+    }
+    void Dispatcher::Post(Task task)
+    {
+        // Notified under the lock, the posted task may release the dispatcher before this call returns
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        tasks_.push_back(std::move(task));
+        tasksReady_.notify_one();
+    }
+    void Dispatcher::Acquire()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // Workers never wait on themselves, a callback chaining further work would otherwise deadlock a full pool
+        if (currentDispatcher != this)
+        {
+            released_.wait(lock, [this]() { return stop_ || outstanding_ < capacity_; });
+        }
+
+        ++outstanding_;
+    }
+    void Dispatcher::Release()
+    {
+        // Notified under the lock for the same reason as in Post
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        --outstanding_;
+        released_.notify_all();
+
+        // A dispatcher destroyed from its own task waits on this as well
+        if (stop_)
+        {
+            tasksReady_.notify_all();
+        }
+    }
+    Executor Dispatcher::GetExecutor()
+    {
+        auto dispatcher = GetPtr();
+
+        return [dispatcher](Task task) { dispatcher->Post(std::move(task)); };
+    }
+    std::size_t Dispatcher::GetNumberThreads() const
+    {
+        return threads_.size();
+    }
+    std::size_t Dispatcher::GetCapacity() const
+    {
+        return capacity_;
+    }
+    std::size_t Dispatcher::GetOutstanding() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return outstanding_;
+    }
+    void Dispatcher::Run()
+    {
+        currentDispatcher = this;
+
+        while (true)
+        {
+            Task task;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                tasksReady_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+
+                // Pending tasks are drained before stopping so no callback is lost
+                if (tasks_.empty())
+                {
+                    return;
+                }
+
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+
+            Execute(task);
+
+            // The task destroyed this dispatcher, its members are gone and this thread was detached
+            if (currentDispatcher != this)
+            {
+                return;
+            }
+        }
+    }
+    void Dispatcher::Execute(const Task& task)
+    {
+        try
+        {
+            task();
+        }
+        catch (const std::exception& e)
+        {
+            logger::Error(header, utils::string::Format("Dispatched task threw: {}", e.what()));
+        }
+        catch (...)
+        {
+            logger::Error(header, "Dispatched task threw an unknown exception");
+        }
+    }
+} // namespace club
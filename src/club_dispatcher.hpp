@@ -0,0 +1,65 @@
+#ifndef CLUB_DISPATCHER_HPP_
+#define CLUB_DISPATCHER_HPP_
+
+#include "club_messages.hpp"
+#include "club_types.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace club
+{
+    DispatcherPtr CreateDispatcher();
+    DispatcherPtr CreateDispatcher(std::size_t numberThreads, std::size_t capacity = 1024);
+    // Library-owned dispatcher used by Event::Then when none is given
+    // It is never destroyed, so exit does not wait for its outstanding callbacks and callbacks fired late still find it
+    DispatcherPtr GetDispatcher();
+
+    // Runs completion callbacks on a bounded pool instead of the driver callback thread
+    // Destruction waits for outstanding callbacks, and may happen from one of the dispatcher's own tasks
+    class Dispatcher : public std::enable_shared_from_this<Dispatcher>
+    {
+    public:
+        virtual ~Dispatcher();
+
+        static DispatcherPtr Create();
+        DispatcherPtr GetPtr();
+        ConstDispatcherPtr GetPtr() const;
+
+        Error Init(std::size_t numberThreads, std::size_t capacity);
+
+        // Never blocks, it is called from driver callback threads
+        void Post(Task task);
+        // Blocks the producer while capacity callbacks are outstanding, a callback is released when it starts running
+        void Acquire();
+        void Release();
+
+        Executor GetExecutor();
+
+        std::size_t GetNumberThreads() const;
+        std::size_t GetCapacity() const;
+        std::size_t GetOutstanding() const;
+
+    protected:
+        Dispatcher() = default;
+
+        void Run();
+        static void Execute(const Task& task);
+
+        bool initialized_{ false };
+        bool stop_{ false };
+
+        std::size_t capacity_{ 0 };
+        std::size_t outstanding_{ 0 };
+
+        mutable std::mutex mutex_;
+        std::condition_variable tasksReady_;
+        std::condition_variable released_;
+        std::deque<Task> tasks_;
+        std::vector<std::thread> threads_;
+    };
+} // namespace club
+
+#endif /* CLUB_DISPATCHER_HPP_ */
@@ -1,7 +1,133 @@
 #include "club_event.hpp"
 
+#include <new>
+
 namespace club
 {
+    namespace
+    {
+        // Events are created for nearly every enqueue, their blocks are recycled per thread instead of going to the heap
+        template <std::size_t Size> class BlockCache
+        {
+        public:
+            ~BlockCache()
+            {
+                destroyed_ = true;
+
+                for (auto it : blocks_)
+                {
+                    ::operator delete(it);
+                }
+            }
+
+            static void* Allocate()
+            {
+                if (destroyed_ || Get().blocks_.empty())
+                {
+                    return ::operator new(Size);
+                }
+
+                auto& blocks = Get().blocks_;
+                auto res = blocks.back();
+                blocks.pop_back();
+
+                return res;
+            }
+            static void Deallocate(void* block)
+            {
+                // Events released during thread exit may outlive the cache of that thread
+                if (destroyed_ || Get().blocks_.size() >= maxBlocks)
+                {
+                    ::operator delete(block);
+
+                    return;
+                }
+
+                Get().blocks_.push_back(block);
+            }
+
+        protected:
+            static BlockCache& Get()
+            {
+                thread_local BlockCache cache;
+
+                return cache;
+            }
+
+            static const std::size_t maxBlocks = 1024;
+            static thread_local bool destroyed_;
+
+            std::vector<void*> blocks_;
+        };
+
+        template <std::size_t Size> thread_local bool BlockCache<Size>::destroyed_ = false;
+
+        template <typename T> struct PoolAllocator
+        {
+            using value_type = T;
+
+            PoolAllocator() = default;
+            template <typename U> PoolAllocator(const PoolAllocator<U>&)
+            {
+            }
+
+            T* allocate(std::size_t n)
+            {
+                if (n != 1)
+                {
+                    return static_cast<T*>(::operator new(n * sizeof(T)));
+                }
+
+                return static_cast<T*>(BlockCache<sizeof(T)>::Allocate());
+            }
+            void deallocate(T* ptr, std::size_t n)
+            {
+                if (n != 1)
+                {
+                    ::operator delete(ptr);
+
+                    return;
+                }
+
+                BlockCache<sizeof(T)>::Deallocate(ptr);
+            }
+
+            template <typename U> bool operator==(const PoolAllocator<U>&) const
+            {
+                return true;
+            }
+        };
+
+        struct Continuation
+        {
+            Dispatcher* dispatcher;
+            EventCallback callback;
+        };
+
+        // The dispatcher waits for its outstanding callbacks before going away, so no reference is taken or dropped here
+        void CL_CALLBACK Continue(cl_event, cl_int status, void* data)
+        {
+            auto continuation = static_cast<Continuation*>(data);
+            auto dispatcher = continuation->dispatcher;
+
+            // Released before the callback runs, the callback may then drop the last reference to the dispatcher
+            dispatcher->Post([dispatcher, callback = std::move(continuation->callback), status]()
+            {
+                dispatcher->Release();
+                callback(status);
+            });
+
+            delete continuation;
+        }
+        void CL_CALLBACK Fulfil(cl_event, cl_int status, void* data)
+        {
+            auto promise = static_cast<std::promise<Error>*>(data);
+
+            promise->set_value(status);
+            delete promise;
+        }
+    } // namespace
+
     EventPtr CreateEvent(cl_event event)
     {
         Error error;
@@ -15,9 +141,27 @@ namespace club
 
         return res;
     }
+    Events GetEvents(const std::vector<EventPtr>& events)
+    {
+        Events res;
+
+        res.reserve(events.size());
+        for (const auto& it : events)
+        {
+            if (it)
+            {
+                res.push_back(it->Get());
+            }
+        }
+
+        return res;
+    }
     Event::~Event()
     {
-        clReleaseEvent(event_);
+        if (event_)
+        {
+            clReleaseEvent(event_);
+        }
     }
     EventPtr Event::Create()
     {
@@ -25,7 +169,7 @@ namespace club
         {
         };
 
-        auto res = std::make_shared<MakeSharedEnabler>();
+        auto res = std::allocate_shared<MakeSharedEnabler>(PoolAllocator<MakeSharedEnabler>());
         return res;
     }
     EventPtr Event::GetPtr()
@@ -43,22 +187,110 @@ namespace club
             return CL_SUCCESS;
         }
 
+        // The event information is only queried when GetInfo is called
         event_ = event;
-        eventInfo_ = GetInfoEvent(event_);
         initialized_ = true;
 
         return CL_SUCCESS;
     }
+    Error Event::Wait() const
+    {
+        Error error;
+
+        error = clWaitForEvents(1, &event_);
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Error waiting for event: {}", messages.at(error)));
+        }
+
+        return error;
+    }
+    Error Event::Then(EventCallback callback, DispatcherPtr dispatcher) const
+    {
+        Error error;
+
+        if (!dispatcher && !(dispatcher = GetDispatcher()))
+        {
+            return CL_OUT_OF_RESOURCES;
+        }
+
+        dispatcher->Acquire();
+
+        auto continuation = new Continuation{ dispatcher.get(), std::move(callback) };
+        error = clSetEventCallback(event_, CL_COMPLETE, &Continue, continuation);
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Event callback could not be set: {}", messages.at(error)));
+
+            delete continuation;
+            dispatcher->Release();
+        }
+
+        return error;
+    }
+    std::future<Error> Event::AsFuture() const
+    {
+        Error error;
+        auto promise = new std::promise<Error>();
+        auto res = promise->get_future();
+
+        // Fulfilling a promise is cheap enough to do on the driver callback thread
+        error = clSetEventCallback(event_, CL_COMPLETE, &Fulfil, promise);
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Event callback could not be set: {}", messages.at(error)));
+
+            promise->set_value(error);
+            delete promise;
+        }
+
+        return res;
+    }
     const cl_event& Event::Get() const
     {
         return event_;
     }
     const EventInfo& Event::GetInfo()
     {
+        if (!infoQueried_)
+        {
+            eventInfo_ = GetInfoEvent(event_);
+            infoQueried_ = true;
+
+            return eventInfo_;
+        }
+
         eventInfo_.status = GetEventInfo<cl_int>(event_, CL_EVENT_COMMAND_EXECUTION_STATUS);
 
         return eventInfo_;
     }
+    EventProfile Event::GetProfile() const
+    {
+        EventProfile res{};
+        Error error;
+
+        if (Wait() != CL_SUCCESS)
+        {
+            return res;
+        }
+
+        error = clGetEventProfilingInfo(event_, CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &res.queued, NULL);
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Event profiling not available: {}", messages.at(error)));
+
+            return res;
+        }
+
+        clGetEventProfilingInfo(event_, CL_PROFILING_COMMAND_SUBMIT, sizeof(cl_ulong), &res.submit, NULL);
+        clGetEventProfilingInfo(event_, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &res.start, NULL);
+        clGetEventProfilingInfo(event_, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &res.end, NULL);
+
+        res.queueWait = res.start - res.queued;
+        res.execution = res.end - res.start;
+
+        return res;
+    }
     EventInfo Event::GetInfoEvent(cl_event event) const
     {
         EventInfo res;
@@ -73,11 +305,9 @@ namespace club
 
     template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type Event::GetEventInfo(cl_event event, cl_mem_info info) const
     {
-        std::size_t size;
-        T res;
+        T res{};
 
-        clGetEventInfo(event, info, 0, NULL, &size);
-        clGetEventInfo(event, info, size, &res, 0);
+        clGetEventInfo(event, info, sizeof(T), &res, 0);
 
         return res;
     }
@@ -1,12 +1,16 @@
 #ifndef CLUB_EVENT_HPP_
 #define CLUB_EVENT_HPP_
 
+#include "club_dispatcher.hpp"
 #include "club_messages.hpp"
 #include "club_types.hpp"
 
+#include <future>
+
 namespace club
 {
     EventPtr CreateEvent(cl_event event);
+    Events GetEvents(const std::vector<EventPtr>& events);
 
     class Event : public std::enable_shared_from_this<Event>
     {
@@ -19,8 +23,14 @@ namespace club
 
         Error Init(cl_event event);
 
+        Error Wait() const;
+        // The callback runs on the dispatcher once the command completes, blocking while the dispatcher is full
+        Error Then(EventCallback callback, DispatcherPtr dispatcher = nullptr) const;
+        std::future<Error> AsFuture() const;
+
         const cl_event& Get() const;
         const EventInfo& GetInfo();
+        EventProfile GetProfile() const;
 
     protected:
         Event() = default;
@@ -33,7 +43,8 @@ namespace club
         typename std::enable_if<is_vector<T>::value, T>::type GetEventInfo(cl_event event, cl_mem_info info) const;
 
         bool initialized_{ false };
-        cl_event event_;
+        bool infoQueried_{ false };
+        cl_event event_{ nullptr };
         EventInfo eventInfo_;
     };
 } // namespace club
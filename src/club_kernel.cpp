@@ -1,9 +1,46 @@
 #include "club_kernel.hpp"
 #include <iostream>
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <cstring>
 
 namespace club
 {
+    namespace
+    {
+        // Threads that exit without calling ReleaseInstance hand their instance slots back here
+        class InstanceGuard
+        {
+        public:
+            ~InstanceGuard()
+            {
+                for (auto& it : kernels_)
+                {
+                    if (auto kernel = it.lock())
+                    {
+                        kernel->ReleaseInstance();
+                    }
+                }
+            }
+
+            static void Register(const KernelPtr& kernel)
+            {
+                thread_local InstanceGuard guard;
+
+                std::erase_if(guard.kernels_, [&](const std::weak_ptr<Kernel>& it)
+                {
+                    return it.expired() || (!it.owner_before(kernel) && !kernel.owner_before(it));
+                });
+                guard.kernels_.push_back(kernel);
+            }
+
+        protected:
+            std::vector<std::weak_ptr<Kernel>> kernels_;
+        };
+    } // namespace
+
     KernelPtr CreateKernel()
     {
         return Kernel::Create();
@@ -27,9 +64,93 @@ namespace club
     {
         return CreateKernel(program, static_cast<String>(kernelName), dim);
     }
+    LocalSize CalculateLocalSize(const KernelInfo& kernelInfo, const DeviceInfo& deviceInfo, const GlobalSize& globalSize)
+    {
+        auto dim = globalSize.size();
+
+        if (dim < 1 || dim > 3 || std::find(globalSize.begin(), globalSize.end(), 0) != globalSize.end())
+        {
+            logger::Error(header, utils::string::Format("Local size not calculated: invalid global size of dimension {:d}", dim));
+
+            return LocalSize();
+        }
+
+        LocalSize res(dim, 1);
+
+        if (kernelInfo.compileWorkGroupSize[0] != 0)
+        {
+            for (Index i = 0; i < dim; ++i)
+            {
+                res[i] = kernelInfo.compileWorkGroupSize[i];
+            }
+
+            return res;
+        }
+
+        if (kernelInfo.localMemSize > deviceInfo.localMemSize)
+        {
+            logger::Error(header, "Kernel local memory exceeds the device local memory");
+
+            return res;
+        }
+
+        // The kernel work-group size already accounts for its register and private memory usage
+        auto limit = std::min(kernelInfo.workGroupSize, deviceInfo.maxWorkGroupSize);
+        auto multiple = std::max<std::size_t>(kernelInfo.preferredWorkGroupSizeMultiple, 1);
+        if (multiple > limit)
+        {
+            multiple = 1;
+        }
+
+        // The fastest dimension takes whole multiples of the preferred width so no SIMD lanes idle
+        auto widest = std::max(std::min(limit, deviceInfo.maxWorItemSizes[0]) / multiple, std::size_t{ 1 }) * multiple;
+        auto padded = ((globalSize[0] + multiple - 1) / multiple) * multiple;
+        res[0] = std::min(widest, padded);
+
+        auto remaining = limit / res[0];
+        for (Index i = 1; i < dim; ++i)
+        {
+            res[i] = std::bit_floor(std::max<std::size_t>(std::min({ remaining, globalSize[i], deviceInfo.maxWorItemSizes[i] }), 1));
+            remaining /= res[i];
+        }
+
+        // Shrink the work-groups until every compute unit gets at least one
+        auto groups = [&]()
+        {
+            std::size_t number = 1;
+            for (Index i = 0; i < dim; ++i)
+            {
+                number *= (globalSize[i] + res[i] - 1) / res[i];
+            }
+
+            return number;
+        };
+
+        while (groups() < deviceInfo.maxComputeUnits)
+        {
+            auto largest = std::max_element(res.begin() + 1, res.end());
+            if (largest != res.end() && *largest > 1 && *largest >= res[0] / multiple)
+            {
+                *largest /= 2;
+            }
+            else if (res[0] / 2 >= multiple && (res[0] / 2) % multiple == 0)
+            {
+                res[0] /= 2;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        return res;
+    }
     Kernel::~Kernel()
     {
-        clReleaseKernel(kernel_);
+        if (kernel_)
+        {
+            clReleaseKernel(kernel_);
+        }
     }
     KernelPtr Kernel::Create()
     {
@@ -74,11 +195,116 @@ namespace club
             return error;
         }
 
-        kernelInfo_ = GetKernelInfo(kernel_);
+        kernelInfo_ = GetKernelInfo(kernel_, program->context_->GetDevice());
         initialized_ = true;
+        program->context_->GetCounters().Add(Counter::KernelsCreated);
 
         return CL_SUCCESS;
     }
+    KernelPtr Kernel::GetInstance()
+    {
+        auto id = std::this_thread::get_id();
+
+        // A slot is only written by the thread that owns it, so reading its kernel needs no lock
+        for (auto& it : instances_)
+        {
+            if (it.owner.load(std::memory_order_acquire) == id)
+            {
+                return it.kernel;
+            }
+        }
+
+        for (auto& it : instances_)
+        {
+            std::thread::id empty;
+            if (it.owner.compare_exchange_strong(empty, id, std::memory_order_acq_rel))
+            {
+                it.kernel = CreateInstance();
+
+                // A failed creation frees the slot so that the next call retries
+                if (!it.kernel)
+                {
+                    it.owner.store(std::thread::id(), std::memory_order_release);
+
+                    return nullptr;
+                }
+
+                InstanceGuard::Register(GetPtr());
+
+                return it.kernel;
+            }
+        }
+
+        // Every slot is taken, the caller gets an instance it alone holds
+        if (!instancesExhausted_.exchange(true, std::memory_order_relaxed))
+        {
+            logger::Info(header, utils::string::Format("Kernel {} instance slots exhausted, further instances are not cached", kernelName_));
+        }
+
+        return CreateInstance();
+    }
+    void Kernel::ReleaseInstance()
+    {
+        auto id = std::this_thread::get_id();
+
+        for (auto& it : instances_)
+        {
+            if (it.owner.load(std::memory_order_acquire) == id)
+            {
+                it.kernel.reset();
+                it.owner.store(std::thread::id(), std::memory_order_release);
+
+                return;
+            }
+        }
+    }
+    KernelPtr Kernel::CreateInstance() const
+    {
+        class MakeSharedEnabler : public Kernel
+        {
+        };
+
+        auto res = std::make_shared<MakeSharedEnabler>();
+        Error error = CL_INVALID_OPERATION;
+        int major = 0;
+        int minor = 0;
+
+        std::sscanf(program_->context_->GetDeviceInfo().version.data(), "OpenCL %d.%d", &major, &minor);
+
+#ifdef CL_VERSION_2_1
+        // Clones keep the argument values, so the cached bindings stay valid
+        if (major > 2 || (major == 2 && minor >= 1))
+        {
+            std::lock_guard<std::mutex> lock(argsMutex_);
+
+            res->kernel_ = clCloneKernel(kernel_, &error);
+            if (error == CL_SUCCESS)
+            {
+                res->args_ = args_;
+            }
+        }
+#endif
+
+        if (error != CL_SUCCESS)
+        {
+            res->kernel_ = clCreateKernel(program_->Get(), kernelName_.c_str(), &error);
+        }
+
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Kernel {} instance could not be created: {}", kernelName_, messages.at(error)));
+
+            return nullptr;
+        }
+
+        res->program_ = program_;
+        res->kernelName_ = kernelName_;
+        res->kernelInfo_ = kernelInfo_;
+        res->localSize_ = localSize_;
+        res->initialized_ = true;
+
+        return res;
+    }
     const cl_kernel& Kernel::GetKernel() const
     {
         return kernel_;
@@ -87,6 +313,10 @@ namespace club
     {
         return program_->Get();
     }
+    ConstProgramPtr Kernel::GetProgramPtr() const
+    {
+        return program_;
+    }
     const KernelInfo& Kernel::GetInfo() const
     {
         return kernelInfo_;
@@ -95,7 +325,7 @@ namespace club
     {
         return kernelName_;
     }
-    KernelInfo Kernel::GetKernelInfo(cl_kernel kernel) const
+    KernelInfo Kernel::GetKernelInfo(cl_kernel kernel, cl_device_id device) const
     {
         KernelInfo res;
 
@@ -106,11 +336,78 @@ namespace club
         res.program = GetKernelInfo<cl_program>(kernel, CL_KERNEL_PROGRAM);
         res.attributes = GetKernelInfo<std::vector<char>>(kernel, CL_KERNEL_ATTRIBUTES);
 
+        res.workGroupSize = GetKernelWorkGroupInfo<std::size_t>(kernel, device, CL_KERNEL_WORK_GROUP_SIZE);
+        res.compileWorkGroupSize = GetKernelWorkGroupInfo<std::array<std::size_t, 3>>(kernel, device, CL_KERNEL_COMPILE_WORK_GROUP_SIZE);
+        res.localMemSize = GetKernelWorkGroupInfo<cl_ulong>(kernel, device, CL_KERNEL_LOCAL_MEM_SIZE);
+        res.preferredWorkGroupSizeMultiple = GetKernelWorkGroupInfo<std::size_t>(kernel, device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE);
+        res.privateMemSize = GetKernelWorkGroupInfo<cl_ulong>(kernel, device, CL_KERNEL_PRIVATE_MEM_SIZE);
+
+        return res;
+    }
+    EventPtr Kernel::Enqueue(const GlobalSize& globalSize, const GlobalOffset& globalOffset, const Events& waitList)
+    {
+        return Enqueue(program_->context_->GetQueuePtr(), globalSize, globalOffset, waitList);
+    }
+    EventPtr Kernel::Enqueue(ConstQueuePtr queue, const GlobalSize& globalSize, const GlobalOffset& globalOffset, const Events& waitList)
+    {
+        EventPtr res{ nullptr };
+        std::array<std::size_t, 3> global;
+        cl_event event{ nullptr };
+        Error error;
+        Probe probe(program_->context_->GetCounters(), Latency::Kernel, kernelName_.c_str());
+
+        auto dim = GetDim();
+        if (dim < 1 || dim > 3 || globalSize.size() != dim || (!globalOffset.empty() && globalOffset.size() != dim))
+        {
+            logger::Error(header, utils::string::Format("Kernel {} not enqueued: invalid dimension {:d}", kernelName_, globalSize.size()));
+
+            return res;
+        }
+
+        if (!queue)
+        {
+            logger::Error(header, utils::string::Format("Kernel {} not enqueued: queue pointer is null", kernelName_));
+
+            return res;
+        }
+
+        // Pad the global size up to a multiple of the local size, kernels must guard against the extra work items
+        for (Index i = 0; i < dim; ++i)
+        {
+            global[i] = ((globalSize[i] + localSize_[i] - 1) / localSize_[i]) * localSize_[i];
+        }
+
+        cl_event* slot = queue->GetEventSlot(event);
+
+        error = clEnqueueNDRangeKernel(queue->Get(), kernel_, dim, globalOffset.empty() ? NULL : globalOffset.data(), global.data(),
+            localSize_.data(), static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), slot);
+
+        if (error != CL_SUCCESS)
+        {
+            queue->SetLastError(error);
+            logger::Error(header, utils::string::Format("Kernel {} could not be enqueued: {}", kernelName_, messages.at(error)));
+        }
+        else
+        {
+            program_->context_->GetCounters().Add(Counter::EnqueueKernel);
+            probe.SetCommand(queue->Get(), event, 0);
+            res = queue->WrapEvent(slot);
+        }
+
         return res;
     }
     void Kernel::SetArg(const ArgNumber& argNumber, std::size_t size_type, const void* ptr)
     {
         Error error;
+        std::lock_guard<std::mutex> lock(argsMutex_);
+
+        // Untyped values bypass the cache so the next typed bind always reaches the driver
+        if (argNumber < args_.size())
+        {
+            args_[argNumber].bound = false;
+        }
+
+        program_->context_->GetCounters().Add(Counter::SetArgCalls);
 
         if ((error = clSetKernelArg(kernel_, argNumber, size_type, ptr)) != CL_SUCCESS)
         {
@@ -119,6 +416,155 @@ namespace club
             return;
         }
     }
+    void Kernel::SetArg(const ArgNumber& argNumber, ConstBufferPtr buffer)
+    {
+        cl_mem mem = buffer ? buffer->Get() : nullptr;
+
+        BindArg(argNumber, sizeof(cl_mem), &mem, false);
+    }
+    void Kernel::SetArg(const ArgNumber& argNumber, std::nullptr_t)
+    {
+        cl_mem mem = nullptr;
+
+        BindArg(argNumber, sizeof(cl_mem), &mem, false);
+    }
+    void Kernel::SetArg(const ArgNumber& argNumber, const LocalMemory& localMemory)
+    {
+        BindArg(argNumber, localMemory.size, nullptr, true);
+    }
+    void Kernel::BindArg(const ArgNumber& argNumber, std::size_t size, const void* ptr, bool local)
+    {
+        Error error;
+        std::lock_guard<std::mutex> lock(argsMutex_);
+
+        if (argNumber >= args_.size())
+        {
+            args_.resize(argNumber + 1);
+        }
+
+        auto& arg = args_[argNumber];
+        if (arg.bound && arg.local == local && arg.value.size() == size && (local || std::memcmp(arg.value.data(), ptr, size) == 0))
+        {
+            program_->context_->GetCounters().Add(Counter::SetArgSkipped);
+
+            return;
+        }
+
+#ifdef DEBUG
+        if (!CheckArg(argNumber, size, local))
+        {
+            return;
+        }
+#endif
+
+        arg.bound = false;
+        program_->context_->GetCounters().Add(Counter::SetArgCalls);
+
+        if ((error = clSetKernelArg(kernel_, argNumber, size, local ? NULL : ptr)) != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Kernel {} argument {:d} could not be set: {}", kernelName_, argNumber, messages.at(error)));
+
+            return;
+        }
+
+        // Local memory arguments only carry a size, the value bytes stay empty
+        arg.local = local;
+        arg.value.resize(size);
+        if (!local)
+        {
+            std::memcpy(arg.value.data(), ptr, size);
+        }
+        arg.bound = true;
+    }
+#ifdef DEBUG
+    bool Kernel::CheckArg(const ArgNumber& argNumber, std::size_t size, bool local) const
+    {
+        cl_kernel_arg_address_qualifier qualifier;
+        std::size_t typeSize;
+        std::vector<char> typeName;
+        Error error;
+
+        if (argNumber >= kernelInfo_.numberArgs)
+        {
+            logger::Error(header, utils::string::Format("Kernel {} has no argument {:d}", kernelName_, argNumber));
+
+            return false;
+        }
+
+        // Argument information is only kept when the program was built with -cl-kernel-arg-info
+        error = clGetKernelArgInfo(kernel_, argNumber, CL_KERNEL_ARG_ADDRESS_QUALIFIER, sizeof(qualifier), &qualifier, NULL);
+        if (error != CL_SUCCESS)
+        {
+            return true;
+        }
+
+        if ((qualifier == CL_KERNEL_ARG_ADDRESS_LOCAL) != local)
+        {
+            logger::Error(header, utils::string::Format("Kernel {} argument {:d}: local memory mismatch", kernelName_, argNumber));
+
+            return false;
+        }
+
+        if (qualifier == CL_KERNEL_ARG_ADDRESS_GLOBAL || qualifier == CL_KERNEL_ARG_ADDRESS_CONSTANT)
+        {
+            if (size != sizeof(cl_mem))
+            {
+                logger::Error(header, utils::string::Format("Kernel {} argument {:d} expects a buffer", kernelName_, argNumber));
+
+                return false;
+            }
+
+            return true;
+        }
+
+        if (qualifier != CL_KERNEL_ARG_ADDRESS_PRIVATE)
+        {
+            return true;
+        }
+
+        clGetKernelArgInfo(kernel_, argNumber, CL_KERNEL_ARG_TYPE_NAME, 0, NULL, &typeSize);
+        typeName.resize(typeSize);
+        if (typeSize == 0 || clGetKernelArgInfo(kernel_, argNumber, CL_KERNEL_ARG_TYPE_NAME, typeSize, typeName.data(), NULL) != CL_SUCCESS)
+        {
+            return true;
+        }
+
+        // Only built-in scalar and vector types have a known size, structures are left unchecked
+        static const std::vector<std::pair<String, std::size_t>> scalars = {
+            { "uchar", 1 }, { "char", 1 }, { "ushort", 2 }, { "short", 2 }, { "half", 2 }, { "uint", 4 }, { "int", 4 },
+            { "float", 4 }, { "ulong", 8 }, { "long", 8 }, { "double", 8 } };
+
+        String name(typeName.data());
+        for (const auto& it : scalars)
+        {
+            if (name.compare(0, it.first.size(), it.first) != 0)
+            {
+                continue;
+            }
+
+            auto suffix = name.substr(it.first.size());
+            if (!suffix.empty() && !std::all_of(suffix.begin(), suffix.end(), [](char c) { return c >= '0' && c <= '9'; }))
+            {
+                return true;
+            }
+
+            // Three component vectors occupy the space of four
+            std::size_t width = suffix.empty() ? 1 : std::stoul(suffix);
+            std::size_t expected = it.second * (width == 3 ? 4 : width);
+            if (size != expected)
+            {
+                logger::Error(header, utils::string::Format("Kernel {} argument {:d} of type {} expects {:d} bytes, got {:d}",
+                    kernelName_, argNumber, name, expected, size));
+
+                return false;
+            }
+
+            return true;
+        }
+
+        return true;
+    }
+#endif
     void Kernel::SetDim(const Dimension& dim)
     {
         localSize_.resize(dim);
@@ -148,6 +594,12 @@ namespace club
             localSize = std::min(32u, utils::math::Power2Floor(static_cast<unsigned int>(std::pow(workGroupSize, 1. / dim))));
         }
 
+        // Never exceed what this kernel can be launched with
+        while (localSize > 1 && std::pow(localSize, dim) > kernelInfo_.workGroupSize)
+        {
+            localSize /= 2;
+        }
+
         for (auto& it : localSize_)
         {
             it = localSize;
@@ -161,6 +613,16 @@ namespace club
     {
         localSize_[index] = size;
     }
+    void Kernel::FitLocalSize(const GlobalSize& globalSize)
+    {
+        auto localSize = CalculateLocalSize(kernelInfo_, program_->context_->GetDeviceInfo(), globalSize);
+
+        // An invalid global size keeps the current local size, the error is already logged
+        if (!localSize.empty())
+        {
+            localSize_ = localSize;
+        }
+    }
     Dimension Kernel::GetDim() const
     {
         return static_cast<Dimension>(localSize_.size());
@@ -188,6 +650,27 @@ namespace club
         res.resize(size);
         clGetKernelInfo(kernel, info, size, &res[0], 0);
 
+        return res;
+    }
+    template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type Kernel::GetKernelWorkGroupInfo(cl_kernel kernel, cl_device_id device, cl_kernel_work_group_info info) const
+    {
+        std::size_t size;
+        T res{};
+
+        clGetKernelWorkGroupInfo(kernel, device, info, 0, NULL, &size);
+        clGetKernelWorkGroupInfo(kernel, device, info, size, &res, 0);
+
+        return res;
+    }
+    template <typename T> typename std::enable_if<is_vector<T>::value, T>::type Kernel::GetKernelWorkGroupInfo(cl_kernel kernel, cl_device_id device, cl_kernel_work_group_info info) const
+    {
+        std::size_t size;
+        T res;
+
+        clGetKernelWorkGroupInfo(kernel, device, info, 0, NULL, &size);
+        res.resize(size);
+        clGetKernelWorkGroupInfo(kernel, device, info, size, &res[0], 0);
+
         return res;
     }
 } // namespace club
\ No newline at end of file
@@ -1,14 +1,24 @@
 #ifndef CLUB_KERNEL_HPP_
 #define CLUB_KERNEL_HPP_
 
+#include "club_buffer.hpp"
+#include "club_event.hpp"
 #include "club_program.hpp"
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
 namespace club
 {
     KernelPtr CreateKernel();
     KernelPtr CreateKernel(ConstProgramPtr program, const String& kernelName, const Dimension& dim);
     KernelPtr CreateKernel(ConstProgramPtr program, const char* kernelName, const Dimension& dim);
 
+    // Empty when the global size does not have 1 to 3 non-zero dimensions
+    LocalSize CalculateLocalSize(const KernelInfo& kernelInfo, const DeviceInfo& deviceInfo, const GlobalSize& globalSize);
+
     class Kernel : public std::enable_shared_from_this<Kernel>
     {
     public:
@@ -20,16 +30,40 @@ namespace club
 
         Error Init(ConstProgramPtr program, const String& kernelName);
 
+        // Returns a kernel owned by the calling thread so threads can bind arguments and launch concurrently
+        // The slot is released by ReleaseInstance or when the calling thread exits
+        KernelPtr GetInstance();
+        void ReleaseInstance();
+
         const cl_kernel& GetKernel() const;
         const cl_program& GetProgram() const;
+        ConstProgramPtr GetProgramPtr() const;
         const KernelInfo& GetInfo() const;
         const String& GetName() const;
 
+        EventPtr Enqueue(const GlobalSize& globalSize, const GlobalOffset& globalOffset = {}, const Events& waitList = {});
+        EventPtr Enqueue(ConstQueuePtr queue, const GlobalSize& globalSize, const GlobalOffset& globalOffset = {}, const Events& waitList = {});
+
         void SetArg(const ArgNumber& argNumber, std::size_t size_type, const void* ptr);
+        void SetArg(const ArgNumber& argNumber, ConstBufferPtr buffer);
+        // Binds a null buffer, not a pointer-sized zero value
+        void SetArg(const ArgNumber& argNumber, std::nullptr_t);
+        void SetArg(const ArgNumber& argNumber, const LocalMemory& localMemory);
+        template <typename T> requires (std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>) void SetArg(const ArgNumber& argNumber, const T& value)
+        {
+            BindArg(argNumber, sizeof(T), &value, false);
+        }
+        // Binds the arguments in order from index zero, unchanged values skip the driver call
+        template <typename... Args> void SetArgs(const Args&... args)
+        {
+            ArgNumber argNumber = 0;
+            (SetArg(argNumber++, args), ...);
+        }
         void SetDim(const Dimension& dim);
         void SetLocalSize(const Dimension& dim);
         void SetLocalSize(const LocalSize& localSize);
         void SetLocalSize(const Index& index, const std::size_t size);
+        void FitLocalSize(const GlobalSize& globalSize);
 
         Dimension GetDim() const;
         const LocalSize& GetLocalSize() const;
@@ -37,19 +71,52 @@ namespace club
     protected:
         Kernel() = default;
 
-        KernelInfo GetKernelInfo(cl_kernel kernel) const;
+        static const std::size_t maxInstances = 32;
+
+        struct Instance
+        {
+            std::atomic<std::thread::id> owner;
+            KernelPtr kernel;
+        };
+
+        KernelPtr CreateInstance() const;
+
+        friend CommandList;
+
+        struct BoundArg
+        {
+            bool bound{ false };
+            bool local{ false };
+            std::vector<unsigned char> value;
+        };
+
+        void BindArg(const ArgNumber& argNumber, std::size_t size, const void* ptr, bool local);
+#ifdef DEBUG
+        bool CheckArg(const ArgNumber& argNumber, std::size_t size, bool local) const;
+#endif
+
+        KernelInfo GetKernelInfo(cl_kernel kernel, cl_device_id device) const;
 
         template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type GetKernelInfo(cl_kernel kernel, cl_kernel_info info) const;
         template <typename T> typename std::enable_if<is_vector<T>::value, T>::type GetKernelInfo(cl_kernel kernel, cl_kernel_info info) const;
 
+        template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type GetKernelWorkGroupInfo(cl_kernel kernel, cl_device_id device, cl_kernel_work_group_info info) const;
+        template <typename T> typename std::enable_if<is_vector<T>::value, T>::type GetKernelWorkGroupInfo(cl_kernel kernel, cl_device_id device, cl_kernel_work_group_info info) const;
+
         bool initialized_{ false };
 
         ConstProgramPtr program_;
 
         String kernelName_;
-        cl_kernel kernel_;
+        cl_kernel kernel_{ nullptr };
         KernelInfo kernelInfo_;
         LocalSize localSize_{ 1, 1, 1 };
+        // Instances are cloned with the argument state while the owning thread may be binding arguments
+        mutable std::mutex argsMutex_;
+        std::vector<BoundArg> args_;
+
+        std::array<Instance, maxInstances> instances_;
+        std::atomic<bool> instancesExhausted_{ false };
     };
 } // namespace club
 
@@ -18,6 +18,23 @@ namespace club
 
         return res;
     }
+    PlatformPtr CreatePlatform(const PlatformFilter& filter)
+    {
+        Error error;
+        auto res = Platform::Create();
+
+        error = res->Init(filter);
+        if (error != CL_SUCCESS)
+        {
+            return nullptr;
+        }
+
+        return res;
+    }
+    std::shared_future<PlatformPtr> CreatePlatformAsync(const PlatformFilter& filter)
+    {
+        return std::async(std::launch::async, [filter]() { return CreatePlatform(filter); }).share();
+    }
     PlatformPtr Platform::Create()
     {
         class MakeSharedEnabler : public Platform
@@ -35,7 +52,7 @@ namespace club
     {
         return const_cast<Platform*>(this)->GetPtr();
     }
-    Error Platform::Init()
+    Error Platform::Init(const PlatformFilter& filter)
     {
         Error error;
 
@@ -44,6 +61,8 @@ namespace club
             return CL_SUCCESS;
         }
 
+        filter_ = filter;
+
         error = InitializePlatforms();
         if (error != CL_SUCCESS)
         {
@@ -52,6 +71,7 @@ namespace club
 
         devices_.resize(platforms_.size());
         devicesInfo_.resize(platforms_.size());
+        devicesOnce_.resize(platforms_.size());
 
         for (PlatformNumber i = 0; i < platforms_.size(); ++i)
         {
@@ -62,14 +82,31 @@ namespace club
             }
         }
 
-        for (PlatformNumber i = 0; i < platforms_.size(); ++i)
+        RemoveEmptyPlatforms();
+
+        // Lazy platforms query the device information on first access instead
+        if (!filter_.lazy)
         {
-			PrintInfoPlatform(platformsInfo_[i], i);
-            
-            for (DeviceNumber j = 0; j < devices_[i].size(); ++j)
+            for (PlatformNumber i = 0; i < platforms_.size(); ++i)
             {
-                PrintInfoDevice(devicesInfo_[i][j], j);
-			}
+                for (DeviceNumber j = 0; j < devices_[i].size(); ++j)
+                {
+                    GetDeviceInfo(i, j);
+                }
+            }
+        }
+
+        if (filter_.print)
+        {
+            for (PlatformNumber i = 0; i < platforms_.size(); ++i)
+            {
+                PrintInfoPlatform(platformsInfo_[i], i);
+
+                for (DeviceNumber j = 0; j < devices_[i].size(); ++j)
+                {
+                    PrintInfoDevice(GetDeviceInfo(i, j), j);
+                }
+            }
         }
 
         initialized_ = true;
@@ -103,6 +140,11 @@ namespace club
     }
     const DeviceInfo& Platform::GetDeviceInfo(const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber) const
     {
+        std::call_once(devicesOnce_[platformNumber][deviceNumber], [&]()
+        {
+            devicesInfo_[platformNumber][deviceNumber] = GetInfoDevice(platformNumber, deviceNumber);
+        });
+
         return devicesInfo_[platformNumber][deviceNumber];
     }
     Error Platform::InitializePlatforms()
@@ -128,13 +170,31 @@ namespace club
             return error;
         }
 
-        logger::Info(header, utils::string::Format("Number of platforms: {:d}", size));
-
         for (PlatformNumber i = 0; i < size; ++i)
         {
             platformsInfo_[i] = GetInfoPlatform(i);
         }
 
+        if (!filter_.vendor.empty())
+        {
+            auto matches = [&](const PlatformInfo& info)
+            {
+                return String(info.vendor.begin(), info.vendor.end()).find(filter_.vendor) != String::npos ||
+                    String(info.name.begin(), info.name.end()).find(filter_.vendor) != String::npos;
+            };
+
+            for (PlatformNumber i = platforms_.size(); i-- > 0;)
+            {
+                if (!matches(platformsInfo_[i]))
+                {
+                    platforms_.erase(platforms_.begin() + i);
+                    platformsInfo_.erase(platformsInfo_.begin() + i);
+                }
+            }
+        }
+
+        logger::Info(header, utils::string::Format("Number of platforms: {:d}", platforms_.size()));
+
         return CL_SUCCESS;
     }
     Error Platform::InitializeDevices(const PlatformNumber& platformNumber)
@@ -142,7 +202,12 @@ namespace club
         Error error;
         Size size;
 
-        error = clGetDeviceIDs(platforms_[platformNumber], CL_DEVICE_TYPE_ALL, 0, NULL, &size);
+        error = clGetDeviceIDs(platforms_[platformNumber], filter_.deviceType, 0, NULL, &size);
+        if (error == CL_DEVICE_NOT_FOUND)
+        {
+            return CL_SUCCESS;
+        }
+
         if (error != CL_SUCCESS)
         {
             logger::Error(header, utils::string::Format("Devices not found in platform: {:d} {} ", platformNumber, messages.at(error)));
@@ -150,11 +215,11 @@ namespace club
             return error;
         }
 
-
         devices_[platformNumber].resize(size);
         devicesInfo_[platformNumber].resize(size);
+        devicesOnce_[platformNumber] = std::make_unique<std::once_flag[]>(size);
 
-        error = clGetDeviceIDs(platforms_[platformNumber], CL_DEVICE_TYPE_ALL, size, &devices_[platformNumber][0], NULL);
+        error = clGetDeviceIDs(platforms_[platformNumber], filter_.deviceType, size, &devices_[platformNumber][0], NULL);
         if (error != CL_SUCCESS)
         {
             logger::Error(header, utils::string::Format("Devices not initialized in platform: {:d} {}", platformNumber, messages.at(error)));
@@ -163,13 +228,23 @@ namespace club
         }
 
         logger::Info(header, utils::string::Format("Number of devices in platform {:d}: {:d}", platformNumber, size));
-        for (DeviceNumber i = 0; i < devices_[platformNumber].size(); ++i)
-        {
-            devicesInfo_[platformNumber][i] = GetInfoDevice(platformNumber, i);
-        }
 
         return CL_SUCCESS;
     }
+    void Platform::RemoveEmptyPlatforms()
+    {
+        for (PlatformNumber i = platforms_.size(); i-- > 0;)
+        {
+            if (devices_[i].empty())
+            {
+                platforms_.erase(platforms_.begin() + i);
+                platformsInfo_.erase(platformsInfo_.begin() + i);
+                devices_.erase(devices_.begin() + i);
+                devicesInfo_.erase(devicesInfo_.begin() + i);
+                devicesOnce_.erase(devicesOnce_.begin() + i);
+            }
+        }
+    }
     PlatformInfo Platform::GetInfoPlatform(const PlatformNumber& platformNumber) const
     {
         PlatformInfo res;
@@ -204,6 +279,7 @@ namespace club
         res.memBaseAddrAlign = GetDeviceInfo<cl_uint>(device, CL_DEVICE_MEM_BASE_ADDR_ALIGN);
         res.minDataTypeAlignSize = GetDeviceInfo<cl_uint>(device, CL_DEVICE_MIN_DATA_TYPE_ALIGN_SIZE);
         res.singleFPConfig = GetDeviceInfo<cl_device_fp_config>(device, CL_DEVICE_SINGLE_FP_CONFIG);
+        res.doubleFPConfig = GetDeviceInfo<cl_device_fp_config>(device, CL_DEVICE_DOUBLE_FP_CONFIG);
         res.globalMemCacheType = GetDeviceInfo<cl_device_mem_cache_type>(device, CL_DEVICE_GLOBAL_MEM_CACHE_TYPE);
         res.globalMemCachelineSize = GetDeviceInfo<cl_uint>(device, CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE);
         res.globalMemCacheSize = GetDeviceInfo<cl_ulong>(device, CL_DEVICE_GLOBAL_MEM_CACHE_SIZE);
@@ -233,11 +309,9 @@ namespace club
     }
     template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type Platform::GetPlatformInfo(cl_platform_id platform, cl_platform_info info) const
     {
-        std::size_t size;
-        T res;
+        T res{};
 
-        clGetPlatformInfo(platform, info, 0, NULL, &size);
-        clGetPlatformInfo(platform, info, size, &res, 0);
+        clGetPlatformInfo(platform, info, sizeof(T), &res, 0);
 
         return res;
     }
@@ -254,11 +328,10 @@ namespace club
     }
     template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type Platform::GetDeviceInfo(cl_device_id device, cl_device_info info) const
     {
-        std::size_t size;
-        T res;
+        T res{};
 
-        clGetDeviceInfo(device, info, 0, NULL, &size);
-        clGetDeviceInfo(device, info, size, &res, 0);
+        // Fixed size values need no size query
+        clGetDeviceInfo(device, info, sizeof(T), &res, 0);
 
         return res;
     }
@@ -4,9 +4,14 @@
 #include "club_messages.hpp"
 #include "club_types.hpp"
 
+#include <future>
+#include <mutex>
+
 namespace club
 {
     PlatformPtr CreatePlatform(bool initialize = true);
+    PlatformPtr CreatePlatform(const PlatformFilter& filter);
+    std::shared_future<PlatformPtr> CreatePlatformAsync(const PlatformFilter& filter = PlatformFilter());
 
     class Platform : public std::enable_shared_from_this<Platform>
     {
@@ -17,7 +22,7 @@ namespace club
         PlatformPtr GetPtr();
         ConstPlatformPtr GetPtr() const;
 
-        Error Init();
+        Error Init(const PlatformFilter& filter = PlatformFilter());
 
         NumberPlatforms GetNumberPlatforms() const;
         NumberDevices GetNumberDevices(const PlatformNumber& platformNumber) const;
@@ -26,6 +31,7 @@ namespace club
         const PlatformInfo& GetInfo(const PlatformNumber& platformNumber) const;
 
         const cl_device_id& GetDevice(const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber) const;
+        // Queried as a whole on first call for lazy platforms, only devices never used save their queries
         const DeviceInfo& GetDeviceInfo(const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber) const;
 
     protected:
@@ -33,6 +39,7 @@ namespace club
 
         Error InitializePlatforms();
         Error InitializeDevices(const PlatformNumber& platformNumber);
+        void RemoveEmptyPlatforms();
 
         PlatformInfo GetInfoPlatform(const PlatformNumber& platformNumber) const;
         DeviceInfo GetInfoDevice(const PlatformNumber& platformNumber, const DeviceNumber& deviceNumber) const;
@@ -44,12 +51,14 @@ namespace club
         template <typename T> typename std::enable_if<is_vector<T>::value, T>::type GetDeviceInfo(cl_device_id device, cl_device_info info) const;
 
         bool initialized_{ false };
+        PlatformFilter filter_;
 
         std::vector<cl_platform_id> platforms_;
         std::vector<PlatformInfo> platformsInfo_;
 
         std::vector<std::vector<cl_device_id>> devices_;
-        std::vector<std::vector<DeviceInfo>> devicesInfo_;
+        mutable std::vector<std::vector<DeviceInfo>> devicesInfo_;
+        mutable std::vector<std::unique_ptr<std::once_flag[]>> devicesOnce_;
     };
 
     void PrintInfoPlatform(const PlatformInfo& platformInfo, const PlatformNumber& platformNumber);
@@ -0,0 +1,314 @@
+#include "club_pool.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace club
+{
+    // Pooled buffers are recycled by the deleter of the pointer handed out, so every GetPtr copy keeps the slot leased
+    class BufferPool::Slot : public Buffer
+    {
+    public:
+        Slot() = default;
+
+        void SetSize(std::size_t size)
+        {
+            size_ = size;
+        }
+    };
+
+    static bool IsComplete(const std::vector<EventPtr>& fences)
+    {
+        for (const auto& it : fences)
+        {
+            cl_int status;
+
+            if (clGetEventInfo(it->Get(), CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(status), &status, NULL) != CL_SUCCESS || status > CL_COMPLETE)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    BufferPoolPtr CreateBufferPool()
+    {
+        return BufferPool::Create();
+    }
+    BufferPoolPtr CreateBufferPool(ConstContextPtr context, std::size_t slabSize, cl_mem_flags flags)
+    {
+        Error error;
+        auto res = BufferPool::Create();
+
+        error = res->Init(context, slabSize, flags);
+        if (error != CL_SUCCESS)
+        {
+            return nullptr;
+        }
+
+        return res;
+    }
+    BufferPool::~BufferPool() = default;
+    BufferPoolPtr BufferPool::Create()
+    {
+        class MakeSharedEnabler : public BufferPool
+        {
+        };
+
+        auto res = std::make_shared<MakeSharedEnabler>();
+        return res;
+    }
+    BufferPoolPtr BufferPool::GetPtr()
+    {
+        return shared_from_this();
+    }
+    ConstBufferPoolPtr BufferPool::GetPtr() const
+    {
+        return const_cast<BufferPool*>(this)->GetPtr();
+    }
+    Error BufferPool::Init(ConstContextPtr context, std::size_t slabSize, cl_mem_flags flags)
+    {
+        if (initialized_)
+        {
+            return CL_SUCCESS;
+        }
+
+        if (!context)
+        {
+            logger::Error(header, "Buffer pool not created: context pointer is null");
+
+            return CL_INVALID_CONTEXT;
+        }
+
+        context_ = context;
+        flags_ = flags;
+
+        // Sub-buffer origins must be aligned to the device base address alignment, which is given in bits
+        alignment_ = std::max<std::size_t>(context_->GetDeviceInfo().memBaseAddrAlign / 8, 1);
+        slabSize_ = std::min<std::size_t>(slabSize, context_->GetDeviceInfo().maxMemAllocSize);
+        slabSize_ = (slabSize_ / alignment_) * alignment_;
+
+        if (slabSize_ == 0)
+        {
+            logger::Error(header, utils::string::Format("Buffer pool not created: invalid slab size {:d}", slabSize));
+
+            return CL_INVALID_BUFFER_SIZE;
+        }
+
+        freeLists_.resize(GetSizeClass(slabSize_) + 1);
+        initialized_ = true;
+
+        return CL_SUCCESS;
+    }
+    BufferPtr BufferPool::Allocate(std::size_t size)
+    {
+        std::unique_ptr<Slot> slot;
+
+        if (size == 0)
+        {
+            logger::Error(header, "Buffer pool cannot allocate an empty buffer");
+
+            return nullptr;
+        }
+
+        auto sizeClass = GetSizeClass(size);
+        auto classSize = GetClassSize(sizeClass);
+
+        if (classSize > slabSize_)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            stats_.oversized++;
+
+            return CreateBuffer(context_, size, flags_);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& freeList = freeLists_[sizeClass];
+
+            stats_.allocations++;
+
+            // Entries released longest ago come first and are the most likely to have completed
+            auto found = std::find_if(freeList.begin(), freeList.end(), [](const Entry& it) { return IsComplete(it.fences); });
+            if (found != freeList.end())
+            {
+                slot = std::move(found->slot);
+                freeList.erase(found);
+
+                stats_.reuses++;
+                stats_.cachedBytes -= classSize;
+            }
+            else
+            {
+                slot = Carve(classSize);
+            }
+
+            if (!slot)
+            {
+                return nullptr;
+            }
+
+            stats_.allocatedBytes += classSize;
+            stats_.requestedBytes += size;
+        }
+
+        slot->SetSize(size);
+
+        return BufferPtr(slot.release(), [pool = GetPtr(), sizeClass, size](Buffer* buffer)
+        {
+            pool->Release(sizeClass, static_cast<Slot*>(buffer), size);
+        });
+    }
+    void BufferPool::Trim()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (Index i = 0; i < freeLists_.size(); ++i)
+        {
+            auto classSize = GetClassSize(i);
+
+            std::erase_if(freeLists_[i], [&](const Entry& it)
+            {
+                if (!IsComplete(it.fences))
+                {
+                    return false;
+                }
+
+                stats_.cachedBytes -= classSize;
+
+                return true;
+            });
+        }
+
+        // Carved buffers hold their slab, so a slab only the pool references has nothing left in it
+        if (!slabs_.empty() && slabs_.back().buffer.use_count() == 1)
+        {
+            slabOffset_ = slabSize_;
+        }
+
+        std::erase_if(slabs_, [](const Slab& it) { return it.buffer.use_count() == 1; });
+    }
+    std::size_t BufferPool::GetAlignment() const
+    {
+        return alignment_;
+    }
+    std::size_t BufferPool::GetSlabSize() const
+    {
+        return slabSize_;
+    }
+    BufferPoolStats BufferPool::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        BufferPoolStats res = stats_;
+
+        res.slabs = slabs_.size();
+        res.wastedBytes = 0;
+        for (const auto& it : slabs_)
+        {
+            res.wastedBytes += it.wasted;
+        }
+
+        res.slabBytes = slabs_.size() * slabSize_;
+        res.availableBytes = slabs_.empty() ? 0 : slabSize_ - slabOffset_;
+
+        if (res.slabBytes > 0)
+        {
+            auto idle = res.allocatedBytes - res.requestedBytes + res.cachedBytes + res.wastedBytes;
+
+            res.utilization = static_cast<Scalar>(res.requestedBytes) / static_cast<Scalar>(res.slabBytes);
+            res.fragmentation = static_cast<Scalar>(idle) / static_cast<Scalar>(res.slabBytes);
+        }
+
+        return res;
+    }
+    Index BufferPool::GetSizeClass(std::size_t size) const
+    {
+        // Classes grow in quarter steps between powers of two of the alignment, bounding the rounding waste to 25%
+        std::size_t units = (size + alignment_ - 1) / alignment_;
+
+        if (units <= 4)
+        {
+            return units - 1;
+        }
+
+        std::size_t power = std::bit_width(units - 1) - 1;
+        std::size_t step = std::size_t{ 1 } << (power - 2);
+        std::size_t quarter = (units - (std::size_t{ 1 } << power) + step - 1) / step;
+
+        return 4 + (power - 2) * 4 + (quarter - 1);
+    }
+    std::size_t BufferPool::GetClassSize(const Index& sizeClass) const
+    {
+        if (sizeClass < 4)
+        {
+            return (sizeClass + 1) * alignment_;
+        }
+
+        std::size_t power = (sizeClass - 4) / 4 + 2;
+        std::size_t quarter = (sizeClass - 4) % 4 + 1;
+
+        return ((std::size_t{ 1 } << power) + quarter * (std::size_t{ 1 } << (power - 2))) * alignment_;
+    }
+    std::unique_ptr<BufferPool::Slot> BufferPool::Carve(std::size_t size)
+    {
+        if (slabs_.empty() || slabOffset_ + size > slabSize_)
+        {
+            auto slab = CreateBuffer(context_, slabSize_, flags_);
+            if (!slab)
+            {
+                logger::Error(header, utils::string::Format("Buffer pool could not allocate a slab of {} (kb)", slabSize_ / 1024));
+
+                return nullptr;
+            }
+
+            if (!slabs_.empty())
+            {
+                slabs_.back().wasted += slabSize_ - slabOffset_;
+            }
+
+            slabs_.push_back({ slab, 0 });
+            slabOffset_ = 0;
+        }
+
+        auto res = std::make_unique<Slot>();
+        if (!res->Init(slabs_.back().buffer, slabOffset_, size))
+        {
+            return nullptr;
+        }
+
+        slabOffset_ += size;
+
+        return res;
+    }
+    void BufferPool::Release(const Index& sizeClass, Slot* slot, std::size_t size)
+    {
+        std::vector<EventPtr> fences;
+        auto classSize = GetClassSize(sizeClass);
+
+        // Commands still using the buffer were enqueued before these markers, reuse waits for them to complete
+        for (NumberQueues i = 0; i < context_->GetNumberQueues(); ++i)
+        {
+            auto queue = context_->GetQueuePtr(i);
+            auto marker = queue ? queue->EnqueueMarker() : nullptr;
+
+            if (marker)
+            {
+                fences.push_back(marker);
+            }
+            else if (queue)
+            {
+                queue->Finish();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        stats_.allocatedBytes -= classSize;
+        stats_.requestedBytes -= size;
+        stats_.cachedBytes += classSize;
+
+        freeLists_[sizeClass].push_back({ std::unique_ptr<Slot>(slot), std::move(fences) });
+    }
+} // namespace club
@@ -0,0 +1,71 @@
+#ifndef CLUB_POOL_HPP_
+#define CLUB_POOL_HPP_
+
+#include "club_buffer.hpp"
+
+#include <mutex>
+
+namespace club
+{
+    BufferPoolPtr CreateBufferPool();
+    BufferPoolPtr CreateBufferPool(ConstContextPtr context, std::size_t slabSize = 64 * 1024 * 1024, cl_mem_flags flags = CL_MEM_READ_WRITE);
+
+    class BufferPool : public std::enable_shared_from_this<BufferPool>
+    {
+    public:
+        virtual ~BufferPool();
+
+        static BufferPoolPtr Create();
+        BufferPoolPtr GetPtr();
+        ConstBufferPoolPtr GetPtr() const;
+
+        Error Init(ConstContextPtr context, std::size_t slabSize, cl_mem_flags flags);
+
+        // The buffer reports the requested size, it returns to the pool once every reference to it is gone
+        // and is handed out again only after the commands enqueued on the context queues before that completed
+        BufferPtr Allocate(std::size_t size);
+        // Frees the cached buffers and the slabs no live buffer is carved from
+        void Trim();
+
+        std::size_t GetAlignment() const;
+        std::size_t GetSlabSize() const;
+        BufferPoolStats GetStats() const;
+
+    protected:
+        BufferPool() = default;
+
+        class Slot;
+
+        struct Entry
+        {
+            std::unique_ptr<Slot> slot;
+            std::vector<EventPtr> fences;
+        };
+        struct Slab
+        {
+            BufferPtr buffer;
+            std::size_t wasted;
+        };
+
+        Index GetSizeClass(std::size_t size) const;
+        std::size_t GetClassSize(const Index& sizeClass) const;
+
+        std::unique_ptr<Slot> Carve(std::size_t size);
+        void Release(const Index& sizeClass, Slot* slot, std::size_t size);
+
+        bool initialized_{ false };
+
+        ConstContextPtr context_{ nullptr };
+        cl_mem_flags flags_{ CL_MEM_READ_WRITE };
+        std::size_t slabSize_{ 0 };
+        std::size_t alignment_{ 1 };
+
+        mutable std::mutex mutex_;
+        std::vector<Slab> slabs_;
+        std::size_t slabOffset_{ 0 };
+        std::vector<std::vector<Entry>> freeLists_;
+        BufferPoolStats stats_{};
+    };
+} // namespace club
+
+#endif
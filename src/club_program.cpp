@@ -1,5 +1,10 @@
 #include "club_program.hpp"
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 namespace club
 {
@@ -7,12 +12,12 @@ namespace club
     {
         return Program::Create();
     }
-    ProgramPtr CreateProgramFromString(ConstContextPtr context, const String& source)
+    ProgramPtr CreateProgramFromString(ConstContextPtr context, const String& source, const String& options)
     {
         Error error;
         auto res = Program::Create();
 
-        error = res->Init(context, source);
+        error = res->Init(context, source, options);
         if (error != CL_SUCCESS)
         {
             return nullptr;
@@ -20,7 +25,7 @@ namespace club
 
         return res;
     }
-    ProgramPtr CreateProgramFromFile(ConstContextPtr context, const String& fileName)
+    ProgramPtr CreateProgramFromFile(ConstContextPtr context, const String& fileName, const String& options)
     {
         File file;
         Error error;
@@ -34,7 +39,7 @@ namespace club
             return nullptr;
         }
 
-        error = res->Init(context, file.GetFull());
+        error = res->Init(context, file.GetFull(), options);
         if (error != CL_SUCCESS)
         {
             return nullptr;
@@ -42,13 +47,127 @@ namespace club
 
         return res;
     }
-    ProgramPtr CreateProgramFromFile(ConstContextPtr context, const char* fileName)
+    ProgramPtr CreateProgramFromFile(ConstContextPtr context, const char* fileName, const String& options)
     {
-        return CreateProgramFromFile(context, static_cast<String>(fileName));
+        return CreateProgramFromFile(context, static_cast<String>(fileName), options);
+    }
+
+    using VariantKey = std::tuple<cl_context, Hash, String, String>;
+
+    // Variants are held weakly, a cached program would otherwise keep its context alive until process exit
+    using VariantFuture = std::shared_future<std::weak_ptr<Program>>;
+
+    static std::mutex variantsMutex;
+    static std::map<VariantKey, VariantFuture> variants;
+
+    static bool IsExpired(const VariantFuture& future)
+    {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready && future.get().expired();
+    }
+
+    ProgramPtr CreateProgramVariant(ConstContextPtr context, const String& source, const String& options)
+    {
+        if (!context)
+        {
+            logger::Error(header, "Invalid context to build program variant");
+
+            return nullptr;
+        }
+
+        VariantKey key{ context->Get(), HashCombine(HashCombine(hashSeed, source), options), options, source };
+
+        while (true)
+        {
+            std::promise<std::weak_ptr<Program>> promise;
+            VariantFuture future;
+
+            {
+                std::lock_guard<std::mutex> lock(variantsMutex);
+
+                std::erase_if(variants, [](const auto& it) { return IsExpired(it.second); });
+
+                auto it = variants.find(key);
+                if (it != variants.end())
+                {
+                    future = it->second;
+                }
+                else
+                {
+                    variants.emplace(key, promise.get_future().share());
+                }
+            }
+
+            // Another thread is already building this variant, it is built again if every user released it meanwhile
+            if (future.valid())
+            {
+                if (auto res = future.get().lock())
+                {
+                    return res;
+                }
+
+                continue;
+            }
+
+            ProgramPtr res;
+
+            // Waiting callers must never see a broken promise, failed builds are retried by the next caller
+            try
+            {
+                res = CreateProgramFromString(context, source, options);
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(variantsMutex);
+
+                    variants.erase(key);
+                }
+
+                promise.set_exception(std::current_exception());
+
+                throw;
+            }
+
+            if (!res)
+            {
+                std::lock_guard<std::mutex> lock(variantsMutex);
+
+                variants.erase(key);
+            }
+
+            promise.set_value(res);
+
+            return res;
+        }
+    }
+    void ClearProgramVariants()
+    {
+        std::lock_guard<std::mutex> lock(variantsMutex);
+
+        variants.clear();
+    }
+    String CreateBuildOptions(const Defines& defines, const String& options)
+    {
+        String res = options;
+
+        for (const auto& it : defines)
+        {
+            res += " -D " + it.first;
+
+            if (!it.second.empty())
+            {
+                res += "=" + it.second;
+            }
+        }
+
+        return res;
     }
     Program::~Program()
     {
-        clReleaseProgram(program_);
+        if (program_)
+        {
+            clReleaseProgram(program_);
+        }
     }
     ProgramPtr Program::Create()
     {
@@ -67,10 +186,10 @@ namespace club
     {
         return const_cast<Program*>(this)->GetPtr();
     }
-    Error Program::Init(ConstContextPtr context, const String& source)
+    Error Program::Init(ConstContextPtr context, const String& source, const String& options)
     {
         Error error;
-        Devices dev;
+        Binary binary;
 
         if (initialized_)
         {
@@ -87,6 +206,55 @@ namespace club
         platform_ = context->GetPlatformPtr();
         context_ = context;
         source_ = source;
+        options_ = options;
+
+        const auto& deviceInfo = platform_->GetDeviceInfo(context_->GetPlatformNumber(), context_->GetDeviceNumber());
+        hash_ = HashCombine(HashCombine(hashSeed, source_), options_);
+        cacheName_ = HashToString(HashCombine(HashCombine(hash_, deviceInfo.name.data(), deviceInfo.name.size()),
+            deviceInfo.driverVersion.data(), deviceInfo.driverVersion.size())) + ".bin";
+
+        const auto& counters = context_->GetCounters();
+        auto begin = std::chrono::steady_clock::now();
+        Probe probe(counters, Latency::Build);
+
+        if (LoadCache(cacheName_, binary))
+        {
+            if (BuildFromBinary(binary) == CL_SUCCESS)
+            {
+                cached_ = true;
+                initialized_ = true;
+                counters.Add(Counter::ProgramsCreated);
+                counters.Add(Counter::ProgramsCached);
+
+                return CL_SUCCESS;
+            }
+
+            logger::Info(header, utils::string::Format("Program binary {} rejected, building from source", cacheName_));
+        }
+
+        error = BuildFromSource();
+        if (error != CL_SUCCESS)
+        {
+            return error;
+        }
+
+        counters.Add(Counter::ProgramsCreated);
+        counters.Add(Counter::BuildTime, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+
+        binary = GetBinary();
+        if (!binary.empty())
+        {
+            StoreCache(cacheName_, binary);
+        }
+
+        initialized_ = true;
+
+        return CL_SUCCESS;
+    }
+    Error Program::BuildFromSource()
+    {
+        Error error;
+        Devices dev;
         auto src = source_.c_str();
 
         program_ = clCreateProgramWithSource(context_->Get(), 1, &src, NULL, &error);
@@ -94,13 +262,15 @@ namespace club
         {
             logger::Error(header, utils::string::Format("Program could not be created with source: {}", messages.at(error)));
 
+            program_ = nullptr;
+
             return error;
         }
         
         dev.resize(1);
         dev[0] = context_->GetDevice();
 
-        error = clBuildProgram(program_, 1, &dev[0], "-cl-std=CL2.0", NULL, NULL);
+        error = clBuildProgram(program_, 1, &dev[0], options_.c_str(), NULL, NULL);
         programInfo_ = GetProgramInfo(program_, context_->GetDevice());
 
         if (error != CL_SUCCESS)
@@ -110,11 +280,61 @@ namespace club
 
             return error;
         }
- 
-        initialized_ = true;
 
         return CL_SUCCESS;
     }
+    Error Program::BuildFromBinary(const Binary& binary)
+    {
+        Error error;
+        Error status;
+        auto device = context_->GetDevice();
+        auto size = binary.size();
+        auto data = binary.data();
+
+        program_ = clCreateProgramWithBinary(context_->Get(), 1, &device, &size, &data, &status, &error);
+        if (error != CL_SUCCESS || status != CL_SUCCESS)
+        {
+            if (program_)
+            {
+                clReleaseProgram(program_);
+                program_ = nullptr;
+            }
+
+            return error != CL_SUCCESS ? error : status;
+        }
+
+        error = clBuildProgram(program_, 1, &device, options_.c_str(), NULL, NULL);
+        if (error != CL_SUCCESS)
+        {
+            clReleaseProgram(program_);
+            program_ = nullptr;
+
+            return error;
+        }
+
+        programInfo_ = GetProgramInfo(program_, device);
+
+        return CL_SUCCESS;
+    }
+    Binary Program::GetBinary() const
+    {
+        Binary res;
+
+        if (programInfo_.binarySizes.empty() || programInfo_.binarySizes[0] == 0)
+        {
+            return res;
+        }
+
+        res.resize(programInfo_.binarySizes[0]);
+        auto data = res.data();
+
+        if (clGetProgramInfo(program_, CL_PROGRAM_BINARIES, sizeof(data), &data, NULL) != CL_SUCCESS)
+        {
+            res.clear();
+        }
+
+        return res;
+    }
     const cl_program& Program::Get() const
     {
         return program_;
@@ -131,6 +351,18 @@ namespace club
     {
         return source_;
     }
+    const String& Program::GetOptions() const
+    {
+        return options_;
+    }
+    const Hash& Program::GetHash() const
+    {
+        return hash_;
+    }
+    bool Program::IsCached() const
+    {
+        return cached_;
+    }
     ProgramInfo Program::GetProgramInfo(cl_program program, cl_device_id device) const
     {
         ProgramInfo res;
@@ -1,14 +1,23 @@
 #ifndef CLUB_PROGRAM_HPP_
 #define CLUB_PROGRAM_HPP_
 
+#include "club_cache.hpp"
 #include "club_context.hpp"
 
 namespace club
 {
+    const String defaultBuildOptions = "-cl-std=CL2.0";
+
     ProgramPtr CreateProgram();
-    ProgramPtr CreateProgramFromString(ConstContextPtr context, const String& source);
-    ProgramPtr CreateProgramFromFile(ConstContextPtr context, const String& fileName);
-    ProgramPtr CreateProgramFromFile(ConstContextPtr context, const char* fileName);
+    ProgramPtr CreateProgramFromString(ConstContextPtr context, const String& source, const String& options = defaultBuildOptions);
+    ProgramPtr CreateProgramFromFile(ConstContextPtr context, const String& fileName, const String& options = defaultBuildOptions);
+    ProgramPtr CreateProgramFromFile(ConstContextPtr context, const char* fileName, const String& options = defaultBuildOptions);
+
+    // Builds each source and options pair once per context while any caller still holds the program
+    ProgramPtr CreateProgramVariant(ConstContextPtr context, const String& source, const String& options = defaultBuildOptions);
+    void ClearProgramVariants();
+
+    String CreateBuildOptions(const Defines& defines, const String& options = defaultBuildOptions);
 
     class Program : public std::enable_shared_from_this<Program>
     {
@@ -19,18 +28,25 @@ namespace club
         ProgramPtr GetPtr();
         ConstProgramPtr GetPtr() const;
 
-        Error Init(ConstContextPtr context, const String& source);
+        Error Init(ConstContextPtr context, const String& source, const String& options = defaultBuildOptions);
 
         const cl_program& Get() const;
         const cl_context& GetContext() const;
         const ProgramInfo& GetInfo() const;
         const String& GetSource() const;
+        const String& GetOptions() const;
+        const Hash& GetHash() const;
+        bool IsCached() const;
 
         friend Kernel;
 
     protected:
         Program() = default;
 
+        Error BuildFromSource();
+        Error BuildFromBinary(const Binary& binary);
+        Binary GetBinary() const;
+
         ProgramInfo GetProgramInfo(cl_program program, cl_device_id device) const;
 
         template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type GetProgramInfo(cl_program program, cl_program_info info) const;
@@ -45,7 +61,12 @@ namespace club
         ConstContextPtr context_{ nullptr };
 
         String source_;
-        cl_program program_;
+        String options_;
+        String cacheName_;
+        Hash hash_{ hashSeed };
+        bool cached_{ false };
+
+        cl_program program_{ nullptr };
         ProgramInfo programInfo_;
     };
 } // namespace club
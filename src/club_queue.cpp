@@ -0,0 +1,221 @@
+#include "club_queue.hpp"
+
+namespace club
+{
+    QueuePtr CreateQueue()
+    {
+        return Queue::Create();
+    }
+    QueuePtr CreateQueue(cl_context context, cl_device_id device, cl_command_queue_properties properties)
+    {
+        Error error;
+        auto res = Queue::Create();
+
+        error = res->Init(context, device, properties);
+        if (error != CL_SUCCESS)
+        {
+            return nullptr;
+        }
+
+        return res;
+    }
+    Queue::~Queue()
+    {
+        if (queue_)
+        {
+            clReleaseCommandQueue(queue_);
+        }
+
+        if (context_)
+        {
+            clReleaseContext(context_);
+        }
+    }
+    QueuePtr Queue::Create()
+    {
+        class MakeSharedEnabler : public Queue
+        {
+        };
+
+        auto res = std::make_shared<MakeSharedEnabler>();
+        return res;
+    }
+    QueuePtr Queue::GetPtr()
+    {
+        return shared_from_this();
+    }
+    ConstQueuePtr Queue::GetPtr() const
+    {
+        return const_cast<Queue*>(this)->GetPtr();
+    }
+    Error Queue::Init(cl_context context, cl_device_id device, cl_command_queue_properties properties)
+    {
+        Error error;
+        cl_queue_properties queueProps[3] = { CL_QUEUE_PROPERTIES, properties, 0 };
+
+        if (initialized_)
+        {
+            return CL_SUCCESS;
+        }
+
+        queue_ = clCreateCommandQueueWithProperties(context, device, queueProps, &error);
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Queue not created: {}", messages.at(error)));
+
+            queue_ = nullptr;
+
+            return error;
+        }
+
+        context_ = context;
+        device_ = device;
+        clRetainContext(context_);
+
+        queueInfo_ = GetQueueInfo(queue_);
+        initialized_ = true;
+
+        return CL_SUCCESS;
+    }
+    EventPtr Queue::EnqueueMarker(const Events& waitList) const
+    {
+        EventPtr res{ nullptr };
+        cl_event event;
+        Error error;
+
+        error = clEnqueueMarkerWithWaitList(queue_, static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), &event);
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Marker could not be enqueued: {}", messages.at(error)));
+        }
+        else
+        {
+            res = CreateEvent(event);
+        }
+
+        return res;
+    }
+    EventPtr Queue::EnqueueBarrier(const Events& waitList) const
+    {
+        EventPtr res{ nullptr };
+        cl_event event;
+        Error error;
+
+        error = clEnqueueBarrierWithWaitList(queue_, static_cast<cl_uint>(waitList.size()), waitList.empty() ? NULL : waitList.data(), &event);
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Barrier could not be enqueued: {}", messages.at(error)));
+        }
+        else
+        {
+            res = CreateEvent(event);
+        }
+
+        return res;
+    }
+    Error Queue::Flush() const
+    {
+        Error error;
+
+        error = clFlush(queue_);
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Queue could not be flushed: {}", messages.at(error)));
+        }
+
+        return error;
+    }
+    Error Queue::Finish() const
+    {
+        Error error;
+
+        error = clFinish(queue_);
+        if (error != CL_SUCCESS)
+        {
+            logger::Error(header, utils::string::Format("Queue could not be finished: {}", messages.at(error)));
+        }
+
+        return error;
+    }
+    const cl_command_queue& Queue::Get() const
+    {
+        return queue_;
+    }
+    const cl_context& Queue::GetContext() const
+    {
+        return context_;
+    }
+    const cl_device_id& Queue::GetDevice() const
+    {
+        return device_;
+    }
+    const QueueInfo& Queue::GetInfo() const
+    {
+        return queueInfo_;
+    }
+    bool Queue::IsOutOfOrder() const
+    {
+        return (queueInfo_.properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) != 0;
+    }
+    bool Queue::IsProfiling() const
+    {
+        return (queueInfo_.properties & CL_QUEUE_PROFILING_ENABLE) != 0;
+    }
+    void Queue::SetEvents(bool events)
+    {
+        events_.store(events, std::memory_order_relaxed);
+    }
+    bool Queue::HasEvents() const
+    {
+        return events_.load(std::memory_order_relaxed);
+    }
+    cl_event* Queue::GetEventSlot(cl_event& event) const
+    {
+        return HasEvents() ? &event : NULL;
+    }
+    EventPtr Queue::WrapEvent(cl_event* slot) const
+    {
+        return slot ? CreateEvent(*slot) : nullptr;
+    }
+    void Queue::SetLastError(Error error) const
+    {
+        Error expected = CL_SUCCESS;
+
+        lastError_.compare_exchange_strong(expected, error, std::memory_order_relaxed);
+    }
+    Error Queue::GetLastError() const
+    {
+        return lastError_.exchange(CL_SUCCESS, std::memory_order_relaxed);
+    }
+    QueueInfo Queue::GetQueueInfo(cl_command_queue queue) const
+    {
+        QueueInfo res;
+
+        res.context = GetQueueInfo<cl_context>(queue, CL_QUEUE_CONTEXT);
+        res.device = GetQueueInfo<cl_device_id>(queue, CL_QUEUE_DEVICE);
+        res.properties = GetQueueInfo<cl_command_queue_properties>(queue, CL_QUEUE_PROPERTIES);
+
+        return res;
+    }
+    template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type Queue::GetQueueInfo(cl_command_queue queue, cl_command_queue_info info) const
+    {
+        std::size_t size;
+        T res;
+
+        clGetCommandQueueInfo(queue, info, 0, NULL, &size);
+        clGetCommandQueueInfo(queue, info, size, &res, 0);
+
+        return res;
+    }
+    template <typename T> typename std::enable_if<is_vector<T>::value, T>::type Queue::GetQueueInfo(cl_command_queue queue, cl_command_queue_info info) const
+    {
+        std::size_t size;
+        T res;
+
+        clGetCommandQueueInfo(queue, info, 0, NULL, &size);
+        res.resize(size);
+        clGetCommandQueueInfo(queue, info, size, &res[0], 0);
+
+        return res;
+    }
+} // namespace club
@@ -0,0 +1,73 @@
+#ifndef CLUB_QUEUE_HPP_
+#define CLUB_QUEUE_HPP_
+
+#include "club_event.hpp"
+#include "club_messages.hpp"
+#include "club_types.hpp"
+
+#include <atomic>
+
+namespace club
+{
+    QueuePtr CreateQueue();
+    QueuePtr CreateQueue(cl_context context, cl_device_id device, cl_command_queue_properties properties = 0);
+
+    class Queue : public std::enable_shared_from_this<Queue>
+    {
+    public:
+        virtual ~Queue();
+
+        static QueuePtr Create();
+        QueuePtr GetPtr();
+        ConstQueuePtr GetPtr() const;
+
+        Error Init(cl_context context, cl_device_id device, cl_command_queue_properties properties);
+
+        EventPtr EnqueueMarker(const Events& waitList = {}) const;
+        EventPtr EnqueueBarrier(const Events& waitList = {}) const;
+
+        Error Flush() const;
+        Error Finish() const;
+
+        const cl_command_queue& Get() const;
+        const cl_context& GetContext() const;
+        const cl_device_id& GetDevice() const;
+        const QueueInfo& GetInfo() const;
+
+        bool IsOutOfOrder() const;
+        bool IsProfiling() const;
+
+        // Without events, enqueues through this queue return null and report failures through GetLastError
+        // Markers and barriers always return an event, they are enqueued only to be waited on
+        void SetEvents(bool events);
+        bool HasEvents() const;
+        // The mode is read once per enqueue: the slot passed to the enqueue is the one given to WrapEvent
+        cl_event* GetEventSlot(cl_event& event) const;
+        EventPtr WrapEvent(cl_event* slot) const;
+
+        void SetLastError(Error error) const;
+        // Returns the first error since the previous call and clears it
+        Error GetLastError() const;
+
+    protected:
+        Queue() = default;
+
+        QueueInfo GetQueueInfo(cl_command_queue queue) const;
+
+        template <typename T> typename std::enable_if<!is_vector<T>::value, T>::type GetQueueInfo(cl_command_queue queue, cl_command_queue_info info) const;
+        template <typename T> typename std::enable_if<is_vector<T>::value, T>::type GetQueueInfo(cl_command_queue queue, cl_command_queue_info info) const;
+
+        bool initialized_{ false };
+
+        cl_context context_{ nullptr };
+        cl_device_id device_{ nullptr };
+        cl_command_queue queue_{ nullptr };
+
+        QueueInfo queueInfo_;
+
+        std::atomic<bool> events_{ true };
+        mutable std::atomic<Error> lastError_{ CL_SUCCESS };
+    };
+} // namespace club
+
+#endif
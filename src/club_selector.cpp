@@ -0,0 +1,182 @@
+#include "club_selector.hpp"
+
+#include "club_buffer.hpp"
+#include "club_kernel.hpp"
+#include "club_program.hpp"
+#include "club_queue.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace club
+{
+    namespace
+    {
+        const String calibrationSource = R"(
+            __kernel void club_calibrate(__global float* data, const int iterations)
+            {
+                size_t id = get_global_id(0);
+                float a = data[id];
+                float b = 1.0001f;
+
+                for (int i = 0; i < iterations; ++i)
+                {
+                    a = mad(a, b, 0.0001f);
+                    b = mad(b, a, -0.0001f);
+                }
+
+                data[id] = a + b;
+            }
+        )";
+
+        const cl_int calibrationIterations = 256;
+        const std::size_t calibrationRepetitions = 3;
+    } // namespace
+
+    Scalar DefaultScore(const DeviceInfo& deviceInfo)
+    {
+        Scalar res;
+
+        if (!deviceInfo.available || !deviceInfo.compilerAvailable)
+        {
+            return 0.0;
+        }
+
+        res = static_cast<Scalar>(deviceInfo.maxComputeUnits) * std::max<cl_uint>(deviceInfo.maxClockFrequency, 1);
+
+        if (deviceInfo.type & CL_DEVICE_TYPE_GPU)
+        {
+            res *= deviceInfo.hostUnifiedMemory ? 4.0 : 16.0;
+        }
+        else if (deviceInfo.type & CL_DEVICE_TYPE_ACCELERATOR)
+        {
+            res *= 8.0;
+        }
+
+        if (deviceInfo.doubleFPConfig != 0)
+        {
+            res *= 1.25;
+        }
+
+        // Memory sizes only break ties between otherwise similar devices
+        res *= std::log2(2.0 + static_cast<Scalar>(deviceInfo.globalMemSize >> 20));
+        res *= std::log2(2.0 + static_cast<Scalar>(deviceInfo.localMemSize >> 10));
+
+        return res;
+    }
+    DeviceRanking RankDevices(ConstPlatformPtr platform, const ScoreFunction& score)
+    {
+        DeviceRanking res;
+
+        if (!platform)
+        {
+            logger::Error(header, "Devices not ranked: platform pointer is null");
+
+            return res;
+        }
+
+        for (PlatformNumber i = 0; i < platform->GetNumberPlatforms(); ++i)
+        {
+            for (DeviceNumber j = 0; j < platform->GetNumberDevices(i); ++j)
+            {
+                res.push_back({ i, j, score(platform->GetDeviceInfo(i, j)) });
+            }
+        }
+
+        std::stable_sort(res.begin(), res.end(), [](const DeviceRank& a, const DeviceRank& b) { return a.score > b.score; });
+
+        return res;
+    }
+    ContextPtr CreateBestContext(ConstPlatformPtr platform, const ScoreFunction& score, std::size_t calibrationCandidates,
+        cl_command_queue_properties properties)
+    {
+        ContextPtr res;
+        Scalar best = 0.0;
+        auto ranking = RankDevices(platform, score);
+
+        if (ranking.empty() || ranking.front().score <= 0.0)
+        {
+            logger::Error(header, "Best context not created: no usable device found");
+
+            return nullptr;
+        }
+
+        if (calibrationCandidates < 2)
+        {
+            return CreateContext(platform, ranking.front().platformNumber, ranking.front().deviceNumber, properties);
+        }
+
+        for (std::size_t i = 0; i < std::min(calibrationCandidates, ranking.size()) && ranking[i].score > 0.0; ++i)
+        {
+            auto context = CreateContext(platform, ranking[i].platformNumber, ranking[i].deviceNumber, properties);
+            if (!context)
+            {
+                continue;
+            }
+
+            auto throughput = CalibrateContext(context);
+            logger::Info(header, utils::string::Format("Calibration of platform {:d} device {:d}: {:.3f} GFLOP/s",
+                ranking[i].platformNumber, ranking[i].deviceNumber, throughput));
+
+            if (!res || throughput > best)
+            {
+                res = context;
+                best = throughput;
+            }
+        }
+
+        return res;
+    }
+    Scalar CalibrateContext(ConstContextPtr context)
+    {
+        cl_ulong best = 0;
+
+        if (!context)
+        {
+            return 0.0;
+        }
+
+        const auto& deviceInfo = context->GetDeviceInfo();
+        const std::size_t globalSize = static_cast<std::size_t>(deviceInfo.maxComputeUnits) * std::max<std::size_t>(deviceInfo.maxWorkGroupSize, 1) * 4;
+
+        auto queue = CreateQueue(context->Get(), context->GetDevice(), CL_QUEUE_PROFILING_ENABLE);
+        auto program = CreateProgramFromString(context, calibrationSource);
+        auto kernel = program ? CreateKernel(program, "club_calibrate", 1) : nullptr;
+        auto buffer = CreateBuffer(context, globalSize * sizeof(cl_float));
+
+        if (!queue || !kernel || !buffer)
+        {
+            return 0.0;
+        }
+
+        // The queue is in order so the fill completes before the first launch
+        buffer->Fill(queue, 1.0f, 0, globalSize * sizeof(cl_float));
+        kernel->SetArg(0, sizeof(cl_mem), &buffer->Get());
+        kernel->SetArg(1, sizeof(cl_int), &calibrationIterations);
+        kernel->FitLocalSize({ globalSize });
+
+        // The first launch absorbs lazy initialization in the driver and is not counted
+        for (std::size_t i = 0; i <= calibrationRepetitions; ++i)
+        {
+            auto event = kernel->Enqueue(queue, { globalSize });
+            if (!event)
+            {
+                return 0.0;
+            }
+
+            auto execution = event->GetProfile().execution;
+            if (i > 0 && (best == 0 || execution < best))
+            {
+                best = execution;
+            }
+        }
+
+        if (best == 0)
+        {
+            return 0.0;
+        }
+
+        // Two multiply-adds per iteration and work item
+        return 4.0 * calibrationIterations * static_cast<Scalar>(globalSize) / static_cast<Scalar>(best);
+    }
+} // namespace club
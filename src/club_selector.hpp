@@ -0,0 +1,25 @@
+#ifndef CLUB_SELECTOR_HPP_
+#define CLUB_SELECTOR_HPP_
+
+#include "club_context.hpp"
+#include "club_platform.hpp"
+
+#include <functional>
+
+namespace club
+{
+    using ScoreFunction = std::function<Scalar(const DeviceInfo& deviceInfo)>;
+    using DeviceRanking = std::vector<DeviceRank>;
+
+    // Prefers discrete devices with more compute throughput and memory, unavailable devices score zero
+    Scalar DefaultScore(const DeviceInfo& deviceInfo);
+
+    DeviceRanking RankDevices(ConstPlatformPtr platform, const ScoreFunction& score = DefaultScore);
+    // Calibrated selection times a short kernel on the best ranked candidates and keeps the fastest one
+    ContextPtr CreateBestContext(ConstPlatformPtr platform, const ScoreFunction& score = DefaultScore, std::size_t calibrationCandidates = 0,
+        cl_command_queue_properties properties = 0);
+
+    Scalar CalibrateContext(ConstContextPtr context);
+} // namespace club
+
+#endif /* CLUB_SELECTOR_HPP_ */
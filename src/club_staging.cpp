@@ -0,0 +1,108 @@
+#include "club_staging.hpp"
+
+namespace club
+{
+    StagingPoolPtr CreateStagingPool()
+    {
+        return StagingPool::Create();
+    }
+    StagingPoolPtr CreateStagingPool(ConstContextPtr context, std::size_t chunkSize, std::size_t numberChunks)
+    {
+        Error error;
+        auto res = StagingPool::Create();
+
+        error = res->Init(context, chunkSize, numberChunks);
+        if (error != CL_SUCCESS)
+        {
+            return nullptr;
+        }
+
+        return res;
+    }
+    StagingPoolPtr StagingPool::Create()
+    {
+        class MakeSharedEnabler : public StagingPool
+        {
+        };
+
+        auto res = std::make_shared<MakeSharedEnabler>();
+        return res;
+    }
+    StagingPoolPtr StagingPool::GetPtr()
+    {
+        return shared_from_this();
+    }
+    ConstStagingPoolPtr StagingPool::GetPtr() const
+    {
+        return const_cast<StagingPool*>(this)->GetPtr();
+    }
+    Error StagingPool::Init(ConstContextPtr context, std::size_t chunkSize, std::size_t numberChunks)
+    {
+        if (initialized_)
+        {
+            return CL_SUCCESS;
+        }
+
+        if (!context)
+        {
+            logger::Error(header, "Staging pool not created: context pointer is null");
+
+            return CL_INVALID_CONTEXT;
+        }
+
+        if (chunkSize == 0 || numberChunks < 2)
+        {
+            logger::Error(header, "Staging pool not created: needs at least two non-empty chunks");
+
+            return CL_INVALID_VALUE;
+        }
+
+        context_ = context;
+        chunkSize_ = chunkSize;
+        slots_.resize(numberChunks);
+
+        // Pinned allocations are mapped once and stay mapped for the lifetime of the pool
+        for (auto& it : slots_)
+        {
+            it.buffer = CreateBuffer(context_, chunkSize_, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR);
+            if (!it.buffer)
+            {
+                slots_.clear();
+
+                return CL_MEM_OBJECT_ALLOCATION_FAILURE;
+            }
+
+            it.map = it.buffer->Map(0, chunkSize_, CL_MAP_READ | CL_MAP_WRITE);
+            if (!it.map)
+            {
+                slots_.clear();
+
+                return CL_MAP_FAILURE;
+            }
+        }
+
+        initialized_ = true;
+
+        return CL_SUCCESS;
+    }
+    std::size_t StagingPool::GetChunkSize() const
+    {
+        return chunkSize_;
+    }
+    std::size_t StagingPool::GetNumberChunks() const
+    {
+        return slots_.size();
+    }
+    StagingPool::Slot& StagingPool::Acquire(const Index& index)
+    {
+        auto& res = slots_[index % slots_.size()];
+
+        if (res.pending)
+        {
+            res.pending->Wait();
+            res.pending = nullptr;
+        }
+
+        return res;
+    }
+} // namespace club
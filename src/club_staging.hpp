@@ -0,0 +1,51 @@
+#ifndef CLUB_STAGING_HPP_
+#define CLUB_STAGING_HPP_
+
+#include "club_buffer.hpp"
+
+#include <mutex>
+
+namespace club
+{
+    StagingPoolPtr CreateStagingPool();
+    StagingPoolPtr CreateStagingPool(ConstContextPtr context, std::size_t chunkSize = 4 * 1024 * 1024, std::size_t numberChunks = 4);
+
+    class StagingPool : public std::enable_shared_from_this<StagingPool>
+    {
+    public:
+        virtual ~StagingPool() = default;
+
+        static StagingPoolPtr Create();
+        StagingPoolPtr GetPtr();
+        ConstStagingPoolPtr GetPtr() const;
+
+        Error Init(ConstContextPtr context, std::size_t chunkSize, std::size_t numberChunks);
+
+        std::size_t GetChunkSize() const;
+        std::size_t GetNumberChunks() const;
+
+        friend Buffer;
+
+    protected:
+        StagingPool() = default;
+
+        struct Slot
+        {
+            BufferPtr buffer;
+            BufferMap map;
+            EventPtr pending;
+        };
+
+        Slot& Acquire(const Index& index);
+
+        bool initialized_{ false };
+
+        ConstContextPtr context_{ nullptr };
+        std::size_t chunkSize_{ 0 };
+
+        std::mutex mutex_;
+        std::vector<Slot> slots_;
+    };
+} // namespace club
+
+#endif
@@ -0,0 +1,219 @@
+#include "club_stream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace club
+{
+    StreamPtr CreateStream()
+    {
+        return Stream::Create();
+    }
+    StreamPtr CreateStream(ConstContextPtr context, KernelPtr kernel, const StreamConfig& config)
+    {
+        Error error;
+        auto res = Stream::Create();
+
+        error = res->Init(context, kernel, config);
+        if (error != CL_SUCCESS)
+        {
+            return nullptr;
+        }
+
+        return res;
+    }
+    StreamPtr Stream::Create()
+    {
+        class MakeSharedEnabler : public Stream
+        {
+        };
+
+        auto res = std::make_shared<MakeSharedEnabler>();
+        return res;
+    }
+    StreamPtr Stream::GetPtr()
+    {
+        return shared_from_this();
+    }
+    ConstStreamPtr Stream::GetPtr() const
+    {
+        return const_cast<Stream*>(this)->GetPtr();
+    }
+    Error Stream::Init(ConstContextPtr context, KernelPtr kernel, const StreamConfig& config)
+    {
+        if (initialized_)
+        {
+            return CL_SUCCESS;
+        }
+
+        if (!context || !kernel)
+        {
+            logger::Error(header, "Stream not created: context or kernel pointer is null");
+
+            return CL_INVALID_VALUE;
+        }
+
+        if (config.chunkItems == 0 || config.inputItemSize == 0 || config.depth < 2)
+        {
+            logger::Error(header, "Stream not created: needs non-empty chunks and a depth of at least two");
+
+            return CL_INVALID_VALUE;
+        }
+
+        context_ = context;
+        kernel_ = kernel;
+        config_ = config;
+
+        // Transfers in each direction and the kernels run on their own queues so they can overlap
+        upload_ = CreateQueue(context_->Get(), context_->GetDevice(), CL_QUEUE_PROFILING_ENABLE);
+        compute_ = CreateQueue(context_->Get(), context_->GetDevice(), CL_QUEUE_PROFILING_ENABLE);
+        download_ = CreateQueue(context_->Get(), context_->GetDevice(), CL_QUEUE_PROFILING_ENABLE);
+        if (!upload_ || !compute_ || !download_)
+        {
+            return CL_INVALID_COMMAND_QUEUE;
+        }
+
+        for (std::size_t i = 0; i < config_.depth; ++i)
+        {
+            inputs_.push_back(CreateBuffer(context_, config_.chunkItems * config_.inputItemSize, CL_MEM_READ_ONLY));
+            if (!inputs_.back())
+            {
+                return CL_MEM_OBJECT_ALLOCATION_FAILURE;
+            }
+
+            if (config_.outputItemSize > 0)
+            {
+                outputs_.push_back(CreateBuffer(context_, config_.chunkItems * config_.outputItemSize, CL_MEM_WRITE_ONLY));
+                if (!outputs_.back())
+                {
+                    return CL_MEM_OBJECT_ALLOCATION_FAILURE;
+                }
+            }
+        }
+
+        initialized_ = true;
+
+        return CL_SUCCESS;
+    }
+    StreamStats Stream::Run(const void* input, void* output, std::size_t count, const StreamBinder& binder)
+    {
+        if (!initialized_)
+        {
+            logger::Error(header, "Stream not initialized");
+
+            return StreamStats{};
+        }
+
+        auto numberChunks = (count + config_.chunkItems - 1) / config_.chunkItems;
+        auto src = static_cast<const unsigned char*>(input);
+        auto dst = static_cast<unsigned char*>(output);
+
+        std::vector<EventPtr> uploads(numberChunks);
+        std::vector<EventPtr> computes(numberChunks);
+        std::vector<EventPtr> downloads(numberChunks);
+
+        auto begin = std::chrono::steady_clock::now();
+
+        for (Index i = 0; i < numberChunks; ++i)
+        {
+            Index slot = i % config_.depth;
+            std::size_t first = i * config_.chunkItems;
+            std::size_t items = std::min(config_.chunkItems, count - first);
+            Events waitList;
+
+            // The input buffer of a slot is free once the kernel of the previous chunk in that slot has run
+            if (i >= config_.depth)
+            {
+                waitList.push_back(computes[i - config_.depth]->Get());
+            }
+
+            uploads[i] = inputs_[slot]->Write(upload_, 0, items * config_.inputItemSize, src + first * config_.inputItemSize, CL_FALSE, waitList);
+            if (!uploads[i])
+            {
+                break;
+            }
+
+            waitList.clear();
+            waitList.push_back(uploads[i]->Get());
+            if (i >= config_.depth && downloads[i - config_.depth])
+            {
+                waitList.push_back(downloads[i - config_.depth]->Get());
+            }
+
+            auto outputBuffer = outputs_.empty() ? nullptr : outputs_[slot];
+            auto globalSize = binder(*kernel_, inputs_[slot], outputBuffer, first, items);
+
+            computes[i] = kernel_->Enqueue(compute_, globalSize, {}, waitList);
+            if (!computes[i])
+            {
+                break;
+            }
+
+            if (outputBuffer)
+            {
+                downloads[i] = outputBuffer->Read(download_, 0, items * config_.outputItemSize, dst + first * config_.outputItemSize, CL_FALSE, { computes[i]->Get() });
+                if (!downloads[i])
+                {
+                    break;
+                }
+            }
+
+            upload_->Flush();
+            compute_->Flush();
+            download_->Flush();
+        }
+
+        upload_->Finish();
+        compute_->Finish();
+        download_->Finish();
+
+        auto res = GetStats(uploads, computes, downloads);
+        res.wallTime = std::chrono::duration<Scalar>(std::chrono::steady_clock::now() - begin).count();
+
+        return res;
+    }
+    const StreamConfig& Stream::GetConfig() const
+    {
+        return config_;
+    }
+    StreamStats Stream::GetStats(const std::vector<EventPtr>& uploads, const std::vector<EventPtr>& computes, const std::vector<EventPtr>& downloads) const
+    {
+        StreamStats res{};
+        cl_ulong first = std::numeric_limits<cl_ulong>::max();
+        cl_ulong last = 0;
+
+        auto accumulate = [&](const std::vector<EventPtr>& events, Scalar& time)
+        {
+            for (const auto& it : events)
+            {
+                if (!it)
+                {
+                    continue;
+                }
+
+                auto profile = it->GetProfile();
+                time += static_cast<Scalar>(profile.execution) * 1e-9;
+                first = std::min(first, profile.start);
+                last = std::max(last, profile.end);
+            }
+        };
+
+        accumulate(uploads, res.uploadTime);
+        accumulate(computes, res.computeTime);
+        accumulate(downloads, res.downloadTime);
+
+        res.chunks = static_cast<std::size_t>(std::count_if(computes.begin(), computes.end(), [](const EventPtr& it) { return it != nullptr; }));
+        res.deviceTime = last > first ? static_cast<Scalar>(last - first) * 1e-9 : 0.;
+
+        // 0 when the stages ran back to back, 1 when the device time shrank to the slowest stage
+        auto busy = res.uploadTime + res.computeTime + res.downloadTime;
+        auto slowest = std::max({ res.uploadTime, res.computeTime, res.downloadTime });
+        if (busy > slowest)
+        {
+            res.overlap = std::clamp((busy - res.deviceTime) / (busy - slowest), 0., 1.);
+        }
+
+        return res;
+    }
+} // namespace club
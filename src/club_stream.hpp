@@ -0,0 +1,51 @@
+#ifndef CLUB_STREAM_HPP_
+#define CLUB_STREAM_HPP_
+
+#include "club_buffer.hpp"
+#include "club_kernel.hpp"
+
+#include <functional>
+
+namespace club
+{
+    using StreamBinder = std::function<GlobalSize(Kernel& kernel, ConstBufferPtr input, ConstBufferPtr output, std::size_t first, std::size_t count)>;
+
+    StreamPtr CreateStream();
+    StreamPtr CreateStream(ConstContextPtr context, KernelPtr kernel, const StreamConfig& config);
+
+    class Stream : public std::enable_shared_from_this<Stream>
+    {
+    public:
+        virtual ~Stream() = default;
+
+        static StreamPtr Create();
+        StreamPtr GetPtr();
+        ConstStreamPtr GetPtr() const;
+
+        Error Init(ConstContextPtr context, KernelPtr kernel, const StreamConfig& config);
+
+        StreamStats Run(const void* input, void* output, std::size_t count, const StreamBinder& binder);
+
+        const StreamConfig& GetConfig() const;
+
+    protected:
+        Stream() = default;
+
+        StreamStats GetStats(const std::vector<EventPtr>& uploads, const std::vector<EventPtr>& computes, const std::vector<EventPtr>& downloads) const;
+
+        bool initialized_{ false };
+
+        ConstContextPtr context_{ nullptr };
+        KernelPtr kernel_{ nullptr };
+        StreamConfig config_{};
+
+        QueuePtr upload_{ nullptr };
+        QueuePtr compute_{ nullptr };
+        QueuePtr download_{ nullptr };
+
+        std::vector<BufferPtr> inputs_;
+        std::vector<BufferPtr> outputs_;
+    };
+} // namespace club
+
+#endif
@@ -0,0 +1,374 @@
+#include "club_trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace club
+{
+    namespace
+    {
+        std::atomic<bool> tracing{ false };
+
+        // Readers validate each slot with its sequence number instead of locking, writers make it odd while they write
+        // The owning thread appends records and their events, harvesting threads claim the events and add the device times
+        class TraceRing
+        {
+        public:
+            ~TraceRing()
+            {
+                for (auto& it : slots_)
+                {
+                    if (auto event = it.event.load(std::memory_order_relaxed))
+                    {
+                        clReleaseEvent(event);
+                    }
+                }
+            }
+
+            void Write(const TraceRecord& record, cl_event event)
+            {
+                auto& slot = Lock(record.position);
+
+                std::memcpy(&slot.record, &record, sizeof(record));
+                Unlock(slot);
+
+                // Published after the record, a harvester that claims the event finds the record it belongs to
+                if (event && clRetainEvent(event) != CL_SUCCESS)
+                {
+                    event = nullptr;
+                }
+
+                // Commands still running when their slot is reused lose their device times
+                if (auto previous = slot.event.exchange(event, std::memory_order_acq_rel))
+                {
+                    clReleaseEvent(previous);
+                }
+            }
+            bool Read(std::uint64_t position, TraceRecord& record) const
+            {
+                const auto& slot = slots_[position % traceCapacity];
+
+                auto before = slot.sequence.load(std::memory_order_acquire);
+                if (before == 0 || before % 2 != 0)
+                {
+                    return false;
+                }
+
+                std::memcpy(&record, &slot.record, sizeof(record));
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                return slot.sequence.load(std::memory_order_relaxed) == before && record.position == position;
+            }
+            void Harvest(bool wait)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                auto head = GetHead();
+                auto position = std::max(harvested_, head > traceCapacity ? head - traceCapacity : 0);
+
+                for (; position < head; ++position)
+                {
+                    auto& slot = slots_[position % traceCapacity];
+                    cl_ulong queued, start, end;
+                    cl_int status = CL_INVALID_EVENT;
+
+                    auto event = slot.event.exchange(nullptr, std::memory_order_acq_rel);
+                    if (!event)
+                    {
+                        continue;
+                    }
+
+                    if (wait)
+                    {
+                        clWaitForEvents(1, &event);
+                    }
+
+                    // Commands complete in order often enough that stopping at the first running one is cheap and close
+                    if (clGetEventInfo(event, CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(status), &status, NULL) == CL_SUCCESS && status > CL_COMPLETE)
+                    {
+                        // The owning thread may have reused the slot meanwhile, the event is then dropped
+                        cl_event expected = nullptr;
+                        if (!slot.event.compare_exchange_strong(expected, event, std::memory_order_acq_rel))
+                        {
+                            clReleaseEvent(event);
+                        }
+
+                        break;
+                    }
+
+                    if (status == CL_COMPLETE &&
+                        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &queued, NULL) == CL_SUCCESS &&
+                        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL) == CL_SUCCESS &&
+                        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL) == CL_SUCCESS)
+                    {
+                        Lock(position);
+
+                        // The event belongs to an older record when the owning thread has reused the slot since
+                        if (slot.record.position == position)
+                        {
+                            slot.record.queued = queued;
+                            slot.record.start = start;
+                            slot.record.end = end;
+                        }
+
+                        Unlock(slot);
+                    }
+
+                    clReleaseEvent(event);
+                }
+
+                harvested_ = position;
+            }
+            std::uint64_t Next()
+            {
+                return head_.load(std::memory_order_relaxed);
+            }
+            void Advance()
+            {
+                head_.fetch_add(1, std::memory_order_release);
+            }
+            std::uint64_t GetHead() const
+            {
+                return head_.load(std::memory_order_acquire);
+            }
+
+        protected:
+            struct Slot
+            {
+                std::atomic<std::uint64_t> sequence{ 0 };
+                TraceRecord record{};
+                std::atomic<cl_event> event{ nullptr };
+            };
+
+            Slot& Lock(std::uint64_t position)
+            {
+                auto& slot = slots_[position % traceCapacity];
+
+                while (true)
+                {
+                    auto sequence = slot.sequence.load(std::memory_order_relaxed);
+                    if (sequence % 2 == 0 && slot.sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire))
+                    {
+                        break;
+                    }
+
+                    std::this_thread::yield();
+                }
+
+                std::atomic_thread_fence(std::memory_order_release);
+
+                return slot;
+            }
+            void Unlock(Slot& slot)
+            {
+                slot.sequence.fetch_add(1, std::memory_order_release);
+            }
+
+            std::atomic<std::uint64_t> head_{ 0 };
+            std::array<Slot, traceCapacity> slots_;
+
+            // Serializes harvesting threads, the owning thread never takes it
+            std::mutex mutex_;
+            std::uint64_t harvested_{ 0 };
+        };
+
+        std::mutex registryMutex;
+        std::vector<std::shared_ptr<TraceRing>> registry;
+        std::deque<std::shared_ptr<TraceRing>> retired;
+
+        std::vector<std::shared_ptr<TraceRing>> GetRings()
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            auto res = registry;
+
+            res.insert(res.end(), retired.begin(), retired.end());
+
+            return res;
+        }
+
+        class TraceThread
+        {
+        public:
+            TraceThread() : ring_(std::make_shared<TraceRing>()), thread_(std::hash<std::thread::id>()(std::this_thread::get_id()))
+            {
+                std::lock_guard<std::mutex> lock(registryMutex);
+
+                registry.push_back(ring_);
+            }
+            ~TraceThread()
+            {
+                ring_->Harvest(false);
+
+                // Records of exited threads stay in the trace, but only for the most recent ones
+                std::lock_guard<std::mutex> lock(registryMutex);
+
+                registry.erase(std::remove(registry.begin(), registry.end(), ring_), registry.end());
+                retired.push_back(ring_);
+                if (retired.size() > traceRetiredThreads)
+                {
+                    retired.pop_front();
+                }
+            }
+
+            // Only appends to the ring, the device times are collected by HarvestTrace and WriteTrace
+            void Record(TraceRecord& record, cl_event event)
+            {
+                record.position = ring_->Next();
+                record.thread = thread_;
+                ring_->Write(record, event);
+                ring_->Advance();
+            }
+
+        protected:
+            std::shared_ptr<TraceRing> ring_;
+            std::uint64_t thread_;
+        };
+
+        TraceThread& GetTraceThread()
+        {
+            thread_local TraceThread thread;
+
+            return thread;
+        }
+
+        String Escape(const char* text)
+        {
+            String res;
+
+            for (auto it = text; *it; ++it)
+            {
+                if (*it == '"' || *it == '\\')
+                {
+                    res += '\\';
+                }
+
+                res += static_cast<unsigned char>(*it) < 0x20 ? ' ' : *it;
+            }
+
+            return res;
+        }
+    } // namespace
+
+    void SetTracing(bool enabled)
+    {
+        tracing.store(enabled, std::memory_order_relaxed);
+    }
+    bool IsTracing()
+    {
+        return tracing.load(std::memory_order_relaxed);
+    }
+    void TraceCommand(TraceRecord record, cl_event event)
+    {
+        GetTraceThread().Record(record, event);
+    }
+    void HarvestTrace(bool wait)
+    {
+        for (const auto& it : GetRings())
+        {
+            it->Harvest(wait);
+        }
+    }
+    std::vector<TraceRecord> GetTrace()
+    {
+        std::vector<TraceRecord> res;
+
+        for (const auto& ring : GetRings())
+        {
+            auto head = ring->GetHead();
+            auto first = head > traceCapacity ? head - traceCapacity : 0;
+
+            for (auto i = first; i < head; ++i)
+            {
+                TraceRecord record;
+
+                if (ring->Read(i, record))
+                {
+                    res.push_back(record);
+                }
+            }
+        }
+
+        std::sort(res.begin(), res.end(), [](const TraceRecord& a, const TraceRecord& b) { return a.hostBegin < b.hostBegin; });
+
+        return res;
+    }
+    Error WriteTrace(const String& fileName)
+    {
+        std::map<std::uint64_t, std::size_t> threads;
+        std::map<cl_command_queue, std::size_t> queues;
+        std::map<cl_command_queue, long long> offsets;
+
+        HarvestTrace(true);
+
+        auto records = GetTrace();
+
+        // Device clocks are aligned per queue, a command is queued between the start and the end of its enqueue call
+        for (const auto& it : records)
+        {
+            threads.emplace(it.thread, threads.size());
+
+            if (it.queue && it.end != 0)
+            {
+                queues.emplace(it.queue, queues.size());
+
+                auto offset = static_cast<long long>(it.hostBegin) - static_cast<long long>(it.queued);
+                auto found = offsets.find(it.queue);
+                if (found == offsets.end() || offset > found->second)
+                {
+                    offsets[it.queue] = offset;
+                }
+            }
+        }
+
+        auto file = std::fopen(fileName.c_str(), "w");
+        if (!file)
+        {
+            logger::Error(header, utils::string::Format("Trace could not be written to {}", fileName));
+
+            return CL_INVALID_VALUE;
+        }
+
+        std::fprintf(file, "{\"traceEvents\":[\n");
+        std::fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"host\"}},\n");
+        std::fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"device\"}}");
+
+        for (const auto& it : threads)
+        {
+            std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"thread %zu\"}}", it.second, it.second);
+        }
+
+        for (const auto& it : queues)
+        {
+            std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":%zu,\"args\":{\"name\":\"queue %zu\"}}", it.second, it.second);
+        }
+
+        for (const auto& it : records)
+        {
+            auto name = Escape(it.name[0] ? it.name : GetName(it.operation));
+
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"bytes\":%llu}}",
+                name.c_str(), GetName(it.operation), threads[it.thread], it.hostBegin / 1e3, (it.hostEnd - it.hostBegin) / 1e3,
+                static_cast<unsigned long long>(it.bytes));
+
+            if (it.queue && it.end != 0)
+            {
+                auto offset = offsets[it.queue];
+
+                std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":2,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"bytes\":%llu,\"wait\":%.3f}}",
+                    name.c_str(), GetName(it.operation), queues[it.queue], (static_cast<long long>(it.start) + offset) / 1e3, (it.end - it.start) / 1e3,
+                    static_cast<unsigned long long>(it.bytes), (it.start - it.queued) / 1e3);
+            }
+        }
+
+        std::fprintf(file, "\n]}\n");
+        std::fclose(file);
+
+        return CL_SUCCESS;
+    }
+} // namespace club
@@ -0,0 +1,44 @@
+#ifndef CLUB_TRACE_HPP_
+#define CLUB_TRACE_HPP_
+
+#include "club_counters.hpp"
+
+namespace club
+{
+    const std::size_t traceNameSize = 48;
+    // Records kept per thread, older ones are overwritten
+    const std::size_t traceCapacity = 4096;
+    // Exited threads whose records are kept, the oldest are dropped first
+    const std::size_t traceRetiredThreads = 8;
+
+    struct TraceRecord
+    {
+        std::uint64_t position;
+        Latency operation;
+        char name[traceNameSize];
+        std::uint64_t bytes;
+        std::uint64_t thread;
+        cl_command_queue queue;
+
+        // Host times are steady clock nanoseconds, device times come from event profiling and stay zero without it
+        std::uint64_t hostBegin;
+        std::uint64_t hostEnd;
+        cl_ulong queued;
+        cl_ulong start;
+        cl_ulong end;
+    };
+
+    void SetTracing(bool enabled);
+    bool IsTracing();
+
+    // Called by Probe, it only appends to the ring of the calling thread and retains the event until HarvestTrace or WriteTrace
+    void TraceCommand(TraceRecord record, cl_event event);
+    // Collects the profiling times of completed commands enqueued by any thread and releases their events
+    void HarvestTrace(bool wait = false);
+
+    std::vector<TraceRecord> GetTrace();
+    // Writes a Chrome trace JSON file with one track per host thread and one per queue
+    Error WriteTrace(const String& fileName);
+} // namespace club
+
+#endif /* CLUB_TRACE_HPP_ */
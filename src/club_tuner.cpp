@@ -0,0 +1,295 @@
+#include "club_tuner.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <limits>
+#include <sstream>
+
+namespace club
+{
+    TunerPtr CreateTuner()
+    {
+        return Tuner::Create();
+    }
+    TunerPtr CreateTuner(ConstContextPtr context, const String& fileName, std::size_t repetitions)
+    {
+        Error error;
+        auto res = Tuner::Create();
+
+        error = res->Init(context, fileName, repetitions);
+        if (error != CL_SUCCESS)
+        {
+            return nullptr;
+        }
+
+        return res;
+    }
+    TunerPtr Tuner::Create()
+    {
+        class MakeSharedEnabler : public Tuner
+        {
+        };
+
+        auto res = std::make_shared<MakeSharedEnabler>();
+        return res;
+    }
+    TunerPtr Tuner::GetPtr()
+    {
+        return shared_from_this();
+    }
+    ConstTunerPtr Tuner::GetPtr() const
+    {
+        return const_cast<Tuner*>(this)->GetPtr();
+    }
+    Error Tuner::Init(ConstContextPtr context, const String& fileName, std::size_t repetitions)
+    {
+        if (initialized_)
+        {
+            return CL_SUCCESS;
+        }
+
+        if (!context)
+        {
+            logger::Error(header, "Tuner not created: context pointer is null");
+
+            return CL_INVALID_CONTEXT;
+        }
+
+        context_ = context;
+        fileName_ = fileName;
+        repetitions_ = std::max<std::size_t>(repetitions, 1);
+
+        // Relative names live in the cache directory when one is set, the working directory otherwise
+        if (auto directory = GetCacheDirectory(); !directory.empty() && std::filesystem::path(fileName).is_relative())
+        {
+            fileName_ = (std::filesystem::path(directory) / fileName).string();
+        }
+
+        queue_ = CreateQueue(context_->Get(), context_->GetDevice(), CL_QUEUE_PROFILING_ENABLE);
+        if (!queue_)
+        {
+            return CL_INVALID_COMMAND_QUEUE;
+        }
+
+        const auto& deviceInfo = context_->GetDeviceInfo();
+        deviceKey_ = HashToString(HashCombine(HashCombine(hashSeed, deviceInfo.name.data(), deviceInfo.name.size()),
+            deviceInfo.driverVersion.data(), deviceInfo.driverVersion.size()));
+
+        Load();
+        initialized_ = true;
+
+        return CL_SUCCESS;
+    }
+    LocalSize Tuner::Tune(KernelPtr kernel, const GlobalSize& globalSize)
+    {
+        LocalSize res;
+        cl_ulong best = std::numeric_limits<cl_ulong>::max();
+        std::vector<std::pair<cl_ulong, LocalSize>> timings;
+
+        if (!kernel || globalSize.size() != kernel->GetDim())
+        {
+            logger::Error(header, "Tuner: kernel is null or its dimension does not match the global size");
+
+            return res;
+        }
+
+        if (Lookup(*kernel, globalSize, res))
+        {
+            kernel->SetLocalSize(res);
+
+            return res;
+        }
+
+        res = kernel->GetLocalSize();
+
+        // A single pass ranks every candidate, the fastest few are then timed again to filter out noise
+        for (const auto& it : GetCandidates(*kernel, globalSize))
+        {
+            auto time = Measure(kernel, globalSize, it, 1);
+            if (time != std::numeric_limits<cl_ulong>::max())
+            {
+                timings.emplace_back(time, it);
+            }
+        }
+
+        std::sort(timings.begin(), timings.end());
+        timings.resize(std::min<std::size_t>(timings.size(), 3));
+
+        for (const auto& it : timings)
+        {
+            auto time = Measure(kernel, globalSize, it.second, repetitions_);
+            if (time < best)
+            {
+                best = time;
+                res = it.second;
+            }
+        }
+
+        kernel->SetLocalSize(res);
+
+        if (best != std::numeric_limits<cl_ulong>::max())
+        {
+            Store(GetKey(*kernel, globalSize), res);
+        }
+
+        return res;
+    }
+    bool Tuner::Lookup(const Kernel& kernel, const GlobalSize& globalSize, LocalSize& localSize)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = results_.find(GetKey(kernel, globalSize));
+        if (it == results_.end() || it->second.size() != globalSize.size())
+        {
+            return false;
+        }
+
+        localSize = it->second;
+
+        return true;
+    }
+    String Tuner::GetKey(const Kernel& kernel, const GlobalSize& globalSize) const
+    {
+        String res = deviceKey_ + ":" + kernel.GetName() + ":" + HashToString(kernel.GetProgramPtr()->GetHash()) + ":";
+
+        // Global sizes are bucketed to the next power of two so nearby problem sizes share a result
+        for (Index i = 0; i < globalSize.size(); ++i)
+        {
+            res += (i > 0 ? "x" : "") + std::to_string(std::bit_ceil(std::max<std::size_t>(globalSize[i], 1)));
+        }
+
+        return res;
+    }
+    std::vector<LocalSize> Tuner::GetCandidates(const Kernel& kernel, const GlobalSize& globalSize) const
+    {
+        std::vector<LocalSize> res;
+        const auto& deviceInfo = context_->GetDeviceInfo();
+        auto dim = globalSize.size();
+        auto limit = std::bit_floor(std::min(kernel.GetInfo().workGroupSize, deviceInfo.maxWorkGroupSize));
+
+        // Power of two shapes whose work-group size is within 1/16 of the limit
+        LocalSize candidate(dim, 1);
+        std::vector<std::size_t> extents(dim);
+        for (Index i = 0; i < dim; ++i)
+        {
+            extents[i] = std::min({ limit, deviceInfo.maxWorItemSizes[i], std::bit_ceil(std::max<std::size_t>(globalSize[i], 1)) });
+        }
+
+        while (true)
+        {
+            std::size_t product = 1;
+            for (auto it : candidate)
+            {
+                product *= it;
+            }
+
+            if (product <= limit && product * 16 >= limit)
+            {
+                res.push_back(candidate);
+            }
+
+            Index i = 0;
+            while (i < dim && candidate[i] * 2 > extents[i])
+            {
+                candidate[i++] = 1;
+            }
+
+            if (i == dim)
+            {
+                break;
+            }
+
+            candidate[i] *= 2;
+        }
+
+        if (res.empty())
+        {
+            res.push_back(LocalSize(dim, 1));
+        }
+
+        return res;
+    }
+    cl_ulong Tuner::Measure(KernelPtr kernel, const GlobalSize& globalSize, const LocalSize& localSize, std::size_t repetitions) const
+    {
+        std::vector<cl_ulong> times;
+
+        kernel->SetLocalSize(localSize);
+
+        for (std::size_t i = 0; i < repetitions; ++i)
+        {
+            auto event = kernel->Enqueue(queue_, globalSize);
+            if (!event)
+            {
+                return std::numeric_limits<cl_ulong>::max();
+            }
+
+            // Failed profiling reads back zeros, a candidate must never look fastest because it was not measured
+            auto profile = event->GetProfile();
+            if (profile.end <= profile.start)
+            {
+                return std::numeric_limits<cl_ulong>::max();
+            }
+
+            times.push_back(profile.execution);
+        }
+
+        std::sort(times.begin(), times.end());
+
+        return times[times.size() / 2];
+    }
+    void Tuner::Load()
+    {
+        Binary data;
+        String line;
+
+        if (!LoadFile(fileName_, data))
+        {
+            return;
+        }
+
+        std::istringstream stream(String(data.begin(), data.end()));
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        while (std::getline(stream, line))
+        {
+            std::istringstream fields(line);
+            String key;
+            LocalSize localSize;
+            std::size_t value;
+
+            fields >> key;
+            while (fields >> value)
+            {
+                localSize.push_back(value);
+            }
+
+            if (!key.empty() && !localSize.empty())
+            {
+                results_[key] = localSize;
+            }
+        }
+    }
+    void Tuner::Store(const String& key, const LocalSize& localSize)
+    {
+        String content;
+
+        // Merge with entries other processes may have written since the file was loaded
+        Load();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_[key] = localSize;
+
+        for (const auto& it : results_)
+        {
+            content += it.first;
+            for (auto size : it.second)
+            {
+                content += " " + std::to_string(size);
+            }
+            content += "\n";
+        }
+
+        StoreFile(fileName_, Binary(content.begin(), content.end()));
+    }
+} // namespace club
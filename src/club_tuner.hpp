@@ -0,0 +1,53 @@
+#ifndef CLUB_TUNER_HPP_
+#define CLUB_TUNER_HPP_
+
+#include "club_kernel.hpp"
+
+#include <map>
+#include <mutex>
+
+namespace club
+{
+    TunerPtr CreateTuner();
+    TunerPtr CreateTuner(ConstContextPtr context, const String& fileName = "tuning.txt", std::size_t repetitions = 5);
+
+    class Tuner : public std::enable_shared_from_this<Tuner>
+    {
+    public:
+        virtual ~Tuner() = default;
+
+        static TunerPtr Create();
+        TunerPtr GetPtr();
+        ConstTunerPtr GetPtr() const;
+
+        Error Init(ConstContextPtr context, const String& fileName, std::size_t repetitions);
+
+        LocalSize Tune(KernelPtr kernel, const GlobalSize& globalSize);
+        bool Lookup(const Kernel& kernel, const GlobalSize& globalSize, LocalSize& localSize);
+
+        String GetKey(const Kernel& kernel, const GlobalSize& globalSize) const;
+
+    protected:
+        Tuner() = default;
+
+        std::vector<LocalSize> GetCandidates(const Kernel& kernel, const GlobalSize& globalSize) const;
+        cl_ulong Measure(KernelPtr kernel, const GlobalSize& globalSize, const LocalSize& localSize, std::size_t repetitions) const;
+
+        void Load();
+        void Store(const String& key, const LocalSize& localSize);
+
+        bool initialized_{ false };
+
+        ConstContextPtr context_{ nullptr };
+        QueuePtr queue_{ nullptr };
+
+        String fileName_;
+        String deviceKey_;
+        std::size_t repetitions_{ 5 };
+
+        std::mutex mutex_;
+        std::map<String, LocalSize> results_;
+    };
+} // namespace club
+
+#endif
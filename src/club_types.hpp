@@ -10,8 +10,12 @@
 #include <CL/cl.h>
 #endif
 
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace club
@@ -25,9 +29,13 @@ namespace club
 
     using NumberDevices = std::size_t;
     using NumberPlatforms = std::size_t;
+    using NumberQueues = std::size_t;
     using GlobalSize = std::vector<std::size_t>;
+    using GlobalOffset = std::vector<std::size_t>;
     using LocalSize = std::vector<std::size_t>;
     using NumberGroups = std::vector<cl_uint>;
+    using Origin = std::array<std::size_t, 3>;
+    using Region = std::array<std::size_t, 3>;
 
     using PlatformNumber = NumberPlatforms;
     using DeviceNumber = NumberDevices;
@@ -38,11 +46,33 @@ namespace club
     using Contexts = std::vector<cl_context>;
     using Programs = std::vector<cl_program>;
 
+    using Defines = std::vector<std::pair<String, String>>;
+
     using ArgNumber = cl_uint;
     using Error = cl_int;
 
+    using CommandId = std::size_t;
+    using CommandIds = std::vector<CommandId>;
+
+    using Task = std::function<void()>;
+    using Executor = std::function<void(Task task)>;
+    using EventCallback = std::function<void(Error status)>;
+
+    using Hash = std::uint64_t;
+    using Binary = std::vector<unsigned char>;
+
     const String header = "CLUB";
+    const Hash hashSeed = 14695981039346656037ull;
+    const CommandId invalidCommand = static_cast<CommandId>(-1);
 
+    struct PlatformFilter
+    {
+        cl_device_type deviceType{ CL_DEVICE_TYPE_ALL };
+        String vendor;
+        // Defers querying a device until its information is first requested, then every field is queried at once
+        bool lazy{ false };
+        bool print{ true };
+    };
     struct PlatformInfo
     {
         std::vector<char> profile;
@@ -67,6 +97,7 @@ namespace club
         cl_uint memBaseAddrAlign;
         cl_uint minDataTypeAlignSize;
         cl_device_fp_config singleFPConfig;
+        cl_device_fp_config doubleFPConfig;
         cl_device_mem_cache_type globalMemCacheType;
         cl_uint globalMemCachelineSize;
         cl_ulong globalMemCacheSize;
@@ -122,6 +153,55 @@ namespace club
         void* hostPtr;
         cl_context context;
     };
+    struct RectLayout
+    {
+        Origin origin;
+        std::size_t rowPitch;
+        std::size_t slicePitch;
+    };
+    struct BufferPoolStats
+    {
+        std::size_t slabs;
+        std::size_t slabBytes;
+        std::size_t requestedBytes;
+        std::size_t allocatedBytes;
+        std::size_t cachedBytes;
+        std::size_t wastedBytes;
+        std::size_t availableBytes;
+        std::size_t allocations;
+        std::size_t reuses;
+        std::size_t oversized;
+
+        Scalar utilization;
+        Scalar fragmentation;
+    };
+    struct StreamConfig
+    {
+        std::size_t chunkItems;
+        std::size_t inputItemSize;
+        std::size_t outputItemSize;
+        std::size_t depth{ 2 };
+    };
+    struct StreamStats
+    {
+        std::size_t chunks;
+
+        Scalar wallTime;
+        Scalar deviceTime;
+        Scalar uploadTime;
+        Scalar computeTime;
+        Scalar downloadTime;
+        Scalar overlap;
+    };
+    struct FlushPolicy
+    {
+        std::size_t commands{ 0 };
+        bool finish{ true };
+    };
+    struct LocalMemory
+    {
+        std::size_t size;
+    };
     struct KernelInfo
     {
         std::vector<char> functionName;
@@ -130,6 +210,12 @@ namespace club
         cl_context context;
         cl_program program;
         std::vector<char> attributes;
+
+        std::size_t workGroupSize;
+        std::array<std::size_t, 3> compileWorkGroupSize;
+        cl_ulong localMemSize;
+        std::size_t preferredWorkGroupSizeMultiple;
+        cl_ulong privateMemSize;
     };
     struct QueueInfo
     {
@@ -144,6 +230,22 @@ namespace club
         cl_command_type type;
         cl_int status;
     };
+    struct DeviceRank
+    {
+        PlatformNumber platformNumber;
+        DeviceNumber deviceNumber;
+        Scalar score;
+    };
+    struct EventProfile
+    {
+        cl_ulong queued;
+        cl_ulong submit;
+        cl_ulong start;
+        cl_ulong end;
+
+        cl_ulong queueWait;
+        cl_ulong execution;
+    };
 
     class Platform;
     using PlatformPtr = std::shared_ptr<Platform>;
@@ -161,10 +263,34 @@ namespace club
     using BufferPtr = std::shared_ptr<Buffer>;
     using ConstBufferPtr = std::shared_ptr<const Buffer>;
 
+    class BufferPool;
+    using BufferPoolPtr = std::shared_ptr<BufferPool>;
+    using ConstBufferPoolPtr = std::shared_ptr<const BufferPool>;
+
+    class StagingPool;
+    using StagingPoolPtr = std::shared_ptr<StagingPool>;
+    using ConstStagingPoolPtr = std::shared_ptr<const StagingPool>;
+
     class Kernel;
     using KernelPtr = std::shared_ptr<Kernel>;
     using ConstKernelPtr = std::shared_ptr<const Kernel>;
 
+    class Stream;
+    using StreamPtr = std::shared_ptr<Stream>;
+    using ConstStreamPtr = std::shared_ptr<const Stream>;
+
+    class Tuner;
+    using TunerPtr = std::shared_ptr<Tuner>;
+    using ConstTunerPtr = std::shared_ptr<const Tuner>;
+
+    class CommandList;
+    using CommandListPtr = std::shared_ptr<CommandList>;
+    using ConstCommandListPtr = std::shared_ptr<const CommandList>;
+
+    class Dispatcher;
+    using DispatcherPtr = std::shared_ptr<Dispatcher>;
+    using ConstDispatcherPtr = std::shared_ptr<const Dispatcher>;
+
     class Queue;
     using QueuePtr = std::shared_ptr<Queue>;
     using ConstQueuePtr = std::shared_ptr<const Queue>;